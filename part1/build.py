@@ -1,12 +1,19 @@
 # Run with: python3 build.py
+# Build one part only with: python3 build.py project   (or: python3 build.py tools, or one tool by name)
 import os
 import platform
+import sys
 
 # (1)==================== COMMON CONFIGURATION OPTIONS ======================= #
 COMPILER="g++ -std=c++17"   # The compiler we want to use 
                                 #(You may try g++ if you have trouble)
 SOURCE="./src/*.cpp"    # Where the source code lives
 EXECUTABLE="project"        # Name of the final executable
+# SDL/OpenGL free sources the tools share
+ENGINE_SOURCE="./src/CubeState.cpp ./src/CubeBatch.cpp ./src/MoveQueue.cpp ./src/AnimationClock.cpp ./src/CubeSimulation.cpp ./src/Transform.cpp ./src/MoveParser.cpp ./src/MoveSimplifier.cpp ./src/ZobristHash.cpp ./src/CubieCube.cpp ./src/TwoPhaseSolver.cpp ./src/AnytimeSolver.cpp ./src/PatternDatabase.cpp ./src/Symmetry.cpp ./src/SolutionCache.cpp ./src/Goal.cpp ./src/OptimalSolver.cpp ./src/ThistlethwaiteSolver.cpp ./src/BidirectionalSolver.cpp ./src/PocketCube.cpp ./src/RandomState.cpp ./src/AlgorithmTable.cpp ./src/LastLayerTable.cpp ./src/CfopSolver.cpp"
+TOOLS=["bench_batch", "headless", "replay", "simplify", "solve", "optimal", "pdbgen", "bench_optimal", "batch_solve", "pattern", "bench_solvers", "bidirectional", "bench_pocket", "random_states", "sample_distances", "llgen", "cfop", "check"]       # Command line tools, each built from ./tools/<name>.cpp
+TOOL_ARGUMENTS="-O2 -pthread" # Tools are benchmarks and batch jobs, always optimize them
+TARGET=sys.argv[1] if len(sys.argv) > 1 else "all"
 # ======================= COMMON CONFIGURATION OPTIONS ======================= #
 
 # (2)=================== Platform specific configuration ===================== #
@@ -18,7 +25,7 @@ LIBRARIES=""            # What libraries do we want to include
 if platform.system()=="Linux":
     ARGUMENTS="-D LINUX" # -D is a #define sent to preprocessor
     INCLUDE_DIR="-I ./include/ -I ./../common/thirdparty/glm/"
-    LIBRARIES="-lSDL2 -ldl"
+    LIBRARIES="-lSDL2 -ldl -pthread"
 elif platform.system()=="Darwin":
     ARGUMENTS="-D MAC" # -D is a #define sent to the preprocessor.
     INCLUDE_DIR="-I ./include/ -I/Library/Frameworks/SDL2.framework/Headers -I./../common/thirdparty/old/glm"
@@ -28,22 +35,34 @@ elif platform.system()=="Windows":
     ARGUMENTS="-D MINGW -std=c++17 -static-libgcc -static-libstdc++" 
     INCLUDE_DIR="-I./include/ -I./../common/thirdparty/old/glm/"
     EXECUTABLE="project.exe"
+    TOOL_ARGUMENTS="-O2 -pthread -std=c++17 -static-libgcc -static-libstdc++"
     LIBRARIES="-lmingw32 -lSDL2main -lSDL2 -mwindows"
 # (2)=================== Platform specific configuration ===================== #
 
 # (3)====================== Building the Executable ========================== #
 # Build a string of our compile commands that we run in the terminal
 compileString=COMPILER+" "+ARGUMENTS+" -o "+EXECUTABLE+" "+" "+INCLUDE_DIR+" "+SOURCE+" "+LIBRARIES
-# Print out the compile string
-# This is the command you can type
-print("============v (Command running on terminal) v===========================")
-print("Compilng on: "+platform.system())
-print(compileString)
-print("========================================================================")
-# Run our command
-os.system(compileString)
+if TARGET in ("all", "project"):
+    # Print out the compile string
+    # This is the command you can type
+    print("============v (Command running on terminal) v===========================")
+    print("Compilng on: "+platform.system())
+    print(compileString)
+    print("========================================================================")
+    # Run our command
+    os.system(compileString)
 # ========================= Building the Executable ========================== #
 
+# (4)======================== Building the Tools ============================= #
+# The tools only need the cube engine, so they build without SDL or OpenGL.
+if TARGET in ("all", "tools") or TARGET in TOOLS:
+    for tool in (TOOLS if TARGET not in TOOLS else [TARGET]):
+        toolExecutable=tool+(".exe" if platform.system()=="Windows" else "")
+        toolString=COMPILER+" "+TOOL_ARGUMENTS+" -o "+toolExecutable+" -I ./include/ -I ./../common/thirdparty/glm/ ./tools/"+tool+".cpp "+ENGINE_SOURCE
+        print(toolString)
+        os.system(toolString)
+# ======================== Building the Tools ================================ #
+
 
 # Why am I not using Make?
 # 1.)   I want total control over the system. 
@@ -0,0 +1,101 @@
+/** @file AlgorithmTable.hpp
+ *  @brief An algorithm for every case of a solving stage, looked up in one step.
+ *
+ *  The cases of a stage are numbered with no gaps, so the table is a plain
+ *  array indexed by the case instead of a hash table that has to probe.
+ *  Each entry is where the case's algorithm starts and how long it is, the
+ *  algorithms are one byte per face turn after that.
+ *
+ *  Tables are filled offline and saved to a versioned file whose header
+ *  names the kind of table and its number of cases. Loading a file maps it
+ *  read only, like the pattern databases, after checking every entry and
+ *  move in it.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef ALGORITHMTABLE_HPP
+#define ALGORITHMTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CubeState.hpp"
+
+class AlgorithmTable{
+public:
+    // bumped whenever the file layout changes
+    static const uint32_t FILE_VERSION = 1;
+    // entries start here in a file, page aligned for mapping
+    static const uint64_t FILE_DATA_OFFSET = 4096;
+    // longest algorithm an entry can hold, the length 255 marks no algorithm
+    static const int MAX_LENGTH = 254;
+
+    // Constructor, a table of cases numbered 0..cases-1 whose files start
+    // with magic (7 characters). No algorithms until Reset or Load.
+    AlgorithmTable(int cases, const char* magic);
+    // Destructor, unmaps a loaded file
+    ~AlgorithmTable();
+    // A table may own a file mapping, so it is never copied
+    AlgorithmTable(const AlgorithmTable&) = delete;
+    AlgorithmTable& operator=(const AlgorithmTable&) = delete;
+
+    // Hold algorithms[number] for every case, in memory. Empty algorithms
+    // (other than for case 0) mean the case has none.
+    void Reset(const std::vector<std::vector<Move>>& algorithms);
+    // Append the algorithm of a case to moves, false if it has none
+    bool Lookup(int number, std::vector<Move>& moves) const;
+    // Face turns in the algorithm of a case, -1 if it has none
+    int Length(int number) const;
+
+    // Number of cases the table is for
+    int NumCases() const;
+    // Number of cases with an algorithm
+    int Cases() const;
+    // Bytes of memory the entries and algorithms take
+    size_t Bytes() const;
+    // True if the table is a read only mapping of a file
+    bool IsMapped() const;
+
+    // Write the table to a file. Returns false and prints why if the
+    // file can not be written.
+    bool Save(const std::string& path) const;
+    // Use the table of a file written by Save. Fails without a message
+    // if there is no file, and with one if it is not a table of this kind
+    // and version or an entry or move in it is out of range.
+    bool Load(const std::string& path);
+
+private:
+    // what a file starts with, the rest of the first page is zero
+    struct FileHeader{
+        char magic[8];
+        uint32_t version;
+        uint32_t cases;
+        uint64_t moveBytes;
+        uint64_t dataOffset;
+    };
+    FileHeader MakeHeader(uint64_t moveBytes) const;
+
+    // an entry is offset << 8 | length, the algorithms follow the entries
+    static const uint32_t NO_ALGORITHM = 0xFF;
+
+    void Unmap();
+    // true if every entry lies inside the algorithms and every algorithm
+    // is face turns
+    bool IsConsistent() const;
+
+    int m_cases;
+    char m_magic[8];
+    // entries and algorithms of a table held in memory
+    std::vector<uint32_t> m_memory;
+    // the ones in use, m_memory or part of a file mapping
+    const uint32_t* m_entries;
+    const uint8_t* m_moves;
+    uint64_t m_moveBytes;
+    // the whole mapped file, nullptr if nothing is mapped
+    void* m_mapping;
+    size_t m_mappingBytes;
+};
+
+#endif
@@ -0,0 +1,37 @@
+/** @file AnimationClock.hpp
+ *  @brief Fixed timestep clock for the simulation.
+ *
+ *  Wall clock time is fed in every frame and handed back as a whole
+ *  number of fixed steps, plus how far into the next step we are so the
+ *  renderer can interpolate. Turns then take the same wall clock time at
+ *  any frame rate.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef ANIMATIONCLOCK_HPP
+#define ANIMATIONCLOCK_HPP
+
+class AnimationClock{
+public:
+    // Constructor, takes the length of one simulation step
+    AnimationClock(double stepSeconds);
+    // Add elapsed wall clock time, returns how many steps to simulate
+    int Advance(double elapsedSeconds);
+    // Fraction [0,1) of a step that has not been simulated yet
+    float Alpha() const;
+    // Length of one simulation step
+    double StepSeconds() const;
+    // Forget any time that has not been simulated yet
+    void Reset();
+
+private:
+    // most steps handed out per frame, so a stall does not snowball
+    static const int MAX_STEPS_PER_FRAME = 30;
+    // length of one simulation step
+    double m_stepSeconds;
+    // elapsed time not yet simulated
+    double m_accumulator;
+};
+
+#endif
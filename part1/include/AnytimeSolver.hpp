@@ -0,0 +1,76 @@
+/** @file AnytimeSolver.hpp
+ *  @brief Two-phase solving on a background thread, best solution so far on demand.
+ *
+ *  The two-phase search finds some solution within milliseconds and then
+ *  spends most of its time looking for shorter ones. An AnytimeSolver runs
+ *  that search on its own thread and publishes every improvement, so a
+ *  caller can take whatever is best when its time budget runs out while
+ *  the search keeps going for a shorter solution in the background.
+ *
+ *  One solve runs at a time, starting another stops the one before it.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef ANYTIMESOLVER_HPP
+#define ANYTIMESOLVER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CubeState.hpp"
+#include "TwoPhaseSolver.hpp"
+
+class AnytimeSolver{
+public:
+    // Constructor, solves with the tables of solver, which has to outlive it
+    AnytimeSolver(const TwoPhaseSolver& solver);
+    // Destructor, stops the search and waits for its thread
+    ~AnytimeSolver();
+    AnytimeSolver(const AnytimeSolver&) = delete;
+    AnytimeSolver& operator=(const AnytimeSolver&) = delete;
+
+    // Start solving state in the background and return at once. The
+    // search stops at a solution of at most targetLength moves, or after
+    // improveSeconds. A solve still running is stopped first.
+    void Start(const CubeState& state, int targetLength, double improveSeconds);
+    // Start, then wait at most budgetMilliseconds for the search to get
+    // anywhere and return the best solution by then. Waits less if the
+    // search finishes first. The search keeps improving afterwards, see
+    // GetBest. Returns false if there was no solution in time or the
+    // state can not be solved.
+    bool Solve(const CubeState& state, std::vector<Move>& solution, int budgetMilliseconds,
+               int targetLength, double improveSeconds);
+    // Stop the search, the best solution so far stays
+    void Stop();
+
+    // Best solution of the current solve so far, without waiting for the
+    // search. Returns its version: 0 while there is no solution yet, one
+    // more for every shorter solution since.
+    int GetBest(std::vector<Move>& solution) const;
+    // True while the search is still looking for shorter solutions.
+    // Finished with version 0 and not stopped, the state can not be solved.
+    bool IsRunning() const;
+    // State of the current solve
+    const CubeState& GetState() const;
+
+private:
+    void Run(const CubeState& state, int targetLength, double improveSeconds);
+
+    const TwoPhaseSolver& m_solver;
+    std::thread m_thread;
+    // set to make the search give up early
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_running;
+    CubeState m_state;
+
+    // guards the published solution, held only to copy it
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::vector<Move> m_best;
+    int m_version;
+};
+
+#endif
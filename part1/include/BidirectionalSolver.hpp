@@ -0,0 +1,96 @@
+/** @file BidirectionalSolver.hpp
+ *  @brief Shortest solutions by meet-in-the-middle, for short scrambles.
+ *
+ *  Breadth first search from the scramble and from the solved cube at
+ *  once. Each level is the sorted set of states at exactly that distance
+ *  from its side, and every state of a new level is looked up in the
+ *  deepest level of the other side; the first one found there is in the
+ *  middle of a shortest solution. The side with the smaller deepest level
+ *  grows next, so a scramble of n moves only goes about n/2 deep on
+ *  either side. The moves are read back by walking down the levels.
+ *
+ *  New states are collected in a buffer of bounded size. A level that
+ *  outgrows it is sorted in runs that are written to files in the work
+ *  directory, merged into a level file, and mapped read only from there.
+ *  The solved side does not depend on the scramble, so its levels are
+ *  kept for every later solve until the solver is destroyed.
+ *
+ *  Positions up to about 14 moves are practical: a side 7 moves deep
+ *  holds about 10^8 states.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef BIDIRECTIONALSOLVER_HPP
+#define BIDIRECTIONALSOLVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CubeState.hpp"
+
+class BidirectionalSolver{
+public:
+    // longest solution searched for by default
+    static const int MAX_LENGTH = 14;
+    // bytes of new states kept in memory by default before spilling to disk
+    static const size_t DEFAULT_MEMORY_BYTES = size_t(256) << 20;
+
+    // What a search did
+    struct Statistics{
+        // states generated, and the deepest level of each side
+        long long states = 0;
+        int scrambleDepth = 0;
+        int solvedDepth = 0;
+        // sorted runs and level files written, and their bytes
+        int runs = 0;
+        uint64_t spilledBytes = 0;
+        double seconds = 0.0;
+    };
+
+    // Constructor. memoryBytes bounds the buffer of new states, larger
+    // levels go to files in workDirectory, which should belong to this
+    // solver alone. Nothing is written until a level needs it.
+    BidirectionalSolver(size_t memoryBytes = DEFAULT_MEMORY_BYTES, const std::string& workDirectory = ".");
+    // Destructor, removes the files of the solved side
+    ~BidirectionalSolver();
+    // Levels may live in files this solver owns, so it is never copied
+    BidirectionalSolver(const BidirectionalSolver&) = delete;
+    BidirectionalSolver& operator=(const BidirectionalSolver&) = delete;
+
+    // Find a shortest solution for state, written to solution. Whole cube
+    // rotations come first if the centers are not home and are not
+    // counted. Center spin is ignored. Returns false if the state can not
+    // be solved in maxLength face turns, or if a level file could not be
+    // written (with a message). Not safe to call from several threads.
+    bool Solve(const CubeState& state, std::vector<Move>& solution,
+               Statistics* statistics = nullptr, int maxLength = MAX_LENGTH);
+
+private:
+    // a whole cube packed into 12 bytes
+    struct Key;
+    // sorted states of one level, or of one run, in memory or in a file
+    struct StateSet;
+    typedef std::vector<std::unique_ptr<StateSet>> Side;
+    // where the two sides met
+    struct Meeting;
+
+    // Add the next level to side, looking every new state up in other.
+    // Stops early, without adding the level, once one is found there.
+    // False only if a file could not be written.
+    bool Expand(Side& side, const std::string& name, const StateSet& other,
+                Meeting& meeting, Statistics& statistics) const;
+    // Moves from the root of side to a state in its level at depth
+    std::vector<Move> PathTo(const Side& side, int depth, const Key& key) const;
+    // File for the states of a side's level or run
+    std::string FilePath(const std::string& name, int depth, int run) const;
+
+    size_t m_memoryBytes;
+    std::string m_workDirectory;
+    // levels from the solved cube, kept between solves
+    Side m_solved;
+};
+
+#endif
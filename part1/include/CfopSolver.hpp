@@ -0,0 +1,105 @@
+/** @file CfopSolver.hpp
+ *  @brief Layer by layer solutions the way people solve (CFOP).
+ *
+ *  The stages a speedcuber goes through, each one a small step:
+ *    cross         the four D edges, read off a distance table of their
+ *                  24^4 positions and flips, so it never searches
+ *    first two     the four corner and middle edge pairs, one at a time,
+ *    layers (F2L)  each one lookup in the pair table: for every pair, set
+ *                  of pairs already solved and place and orientation of
+ *                  the pair's corner and edge, the fewest face turns that
+ *                  solve it and keep the cross and those pairs. The pair
+ *                  with the shortest algorithm goes next.
+ *    last layer    one lookup in a LastLayerTable, an algorithm for each of
+ *                  the 62,208 cases (what OLL then PLL do in two looks)
+ *  Solutions are much longer than the other solvers', but they read like
+ *  a person's. No stage searches, so no solve takes much longer than
+ *  another: on its 10,000 random scrambles ./bench_solvers measured 42.4
+ *  face turns and 2 microseconds on average, 40 microseconds at worst.
+ *
+ *  Both tables are generated offline (the llgen tool). The pair table
+ *  comes from an iterative deepening search for each of its 8,256 cases.
+ *  The last layer table lists every sequence up to some length that keeps
+ *  the first two layers, which gives the shortest algorithm for the cases
+ *  they reach, and then joins short ones, cheapest first, for the rest.
+ *  The solver maps the tables from files, or generates them at startup
+ *  (a smaller last layer table) if there are none.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef CFOPSOLVER_HPP
+#define CFOPSOLVER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "CubeState.hpp"
+#include "LastLayerTable.hpp"
+
+class CfopSolver{
+public:
+    static const int NUM_PAIRS = 4;
+    // sequences llgen lists by default, and the solver when it has no file
+    static const int DEFAULT_TABLE_LENGTH = 12;
+    static const int STARTUP_TABLE_LENGTH = 10;
+    // solved pair masks * pairs * corner states * edge states
+    static const int NUM_PAIR_CASES = (1 << NUM_PAIRS)*NUM_PAIRS*24*24;
+    // what pair table files start with
+    static constexpr const char* PAIR_TABLE_MAGIC = "CUBEF2L";
+
+    // Face turns each stage took
+    struct Stages{
+        int cross = 0;
+        // in the order they were solved, 0 for pairs solved on the way
+        int pairs[NUM_PAIRS] = {0, 0, 0, 0};
+        int lastLayer = 0;
+    };
+
+    // Constructor, maps the pair and last layer tables from
+    // tableDirectory. With generateMissing, a table that is not there (or
+    // every table, if the directory is empty) is generated with threads
+    // threads, 0 means one per core, the last layer one from sequences up
+    // to STARTUP_TABLE_LENGTH. That takes seconds per core. Without it the
+    // table stays empty and nothing can be solved, see HasTables.
+    CfopSolver(const std::string& tableDirectory = "", int threads = 0, bool generateMissing = true);
+
+    // Find a solution for state, written to solution. Whole cube rotations
+    // come first if the centers are not home, the rest are face turns,
+    // merged where one stage ends and the next starts. Center spin is
+    // ignored. Returns false for states that can not be solved. Safe to
+    // call from several threads at once.
+    bool Solve(const CubeState& state, std::vector<Move>& solution, Stages* stages = nullptr) const;
+
+    // The last layer algorithms
+    const LastLayerTable& Table() const;
+    // The first two layer algorithms
+    const AlgorithmTable& PairTable() const;
+    // True if both tables were mapped from files
+    bool TableLoaded() const;
+    // True if both tables were mapped or generated, so Solve can work
+    bool HasTables() const;
+    // Bytes of memory the tables take
+    size_t MemoryFootprint() const;
+
+    // Fill table with an algorithm for every last layer case from the
+    // sequences of up to maxLength face turns that keep the first two
+    // layers. The listing is split over threads, 0 means one per core.
+    static void GenerateTable(LastLayerTable& table, int maxLength, int threads = 0);
+    // Fill table with the shortest algorithm for every pair case, the
+    // searches are split over threads, 0 means one per core
+    static void GeneratePairTable(AlgorithmTable& table, int threads = 0);
+    // Number of pair cases, other than solved pairs, whose algorithm is
+    // missing or does not solve the pair and keep the cross and the pairs
+    // solved before it. The number of cases checked goes to cases.
+    static int CheckPairTable(const AlgorithmTable& table, int* cases = nullptr);
+    // Where the tables of a directory are
+    static std::string TablePath(const std::string& tableDirectory);
+    static std::string PairTablePath(const std::string& tableDirectory);
+
+private:
+    LastLayerTable m_lastLayer;
+    AlgorithmTable m_pairs;
+};
+
+#endif
@@ -0,0 +1,46 @@
+/** @file CubeBatch.hpp
+ *  @brief Applies moves to many independent cube states at once.
+ *
+ *  Each packed CubeState is moved with byte shuffles (pshufb) on CPUs
+ *  that support SSSE3 or AVX2, with a scalar fallback everywhere else.
+ *  The best implementation is picked at runtime.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef CUBEBATCH_HPP
+#define CUBEBATCH_HPP
+
+#include <cstddef>
+#include "CubeState.hpp"
+
+class CubeBatch{
+public:
+    // ways of applying a move, fastest last
+    enum class Implementation
+    {
+        SCALAR,
+        SSSE3,
+        AVX2
+    };
+
+    // Apply the same move to every state
+    static void ApplyMove(CubeState* states, size_t count, Move move);
+    static void ApplyMove(CubeState* states, size_t count, Move move, Implementation implementation);
+    // Apply moves[i] to states[i]
+    static void ApplyMoves(CubeState* states, const Move* moves, size_t count);
+    static void ApplyMoves(CubeState* states, const Move* moves, size_t count, Implementation implementation);
+
+    // Fastest implementation this CPU supports
+    static Implementation Best();
+    // True if this CPU can run the implementation
+    static bool Supported(Implementation implementation);
+    // Name for logging, e.g. "avx2"
+    static const char* Name(Implementation implementation);
+
+private:
+    // packed bytes of a state, states in an array are PACKED_SIZE apart
+    static uint8_t* Bytes(CubeState* state);
+};
+
+#endif
@@ -0,0 +1,102 @@
+/** @file CubeSimulation.hpp
+ *  @brief Cube logic, turn animation and sub cube transforms.
+ *
+ *  Everything that happens to the cube between frames, with no window or
+ *  OpenGL context. SDLGraphicsProgram copies the transforms into its
+ *  objects to draw them; headless tools drive it directly.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef CUBESIMULATION_HPP
+#define CUBESIMULATION_HPP
+
+#include "CubeState.hpp"
+#include "MoveQueue.hpp"
+#include "Transform.hpp"
+#include "TranspositionTable.hpp"
+
+class CubeSimulation{
+public:
+    // number of sub cubes = (9*3)
+    // Note: simulating the middle cube makes math easier even if it's not used
+    static const int NUM_SUB_CUBES = 27;
+    // limits for how long a quarter turn takes
+    static constexpr float MIN_TURN_DURATION = 0.05f;
+    static constexpr float MAX_TURN_DURATION = 5.0f;
+
+    // Constructor, starts out solved with nothing queued
+    CubeSimulation();
+    // Fixed timestep update, advances the active turn and starts queued ones
+    void Step(float seconds);
+    // Rebuild every sub cube's model transform, alpha is how far we are
+    // between the last step and the next one
+    void ComputeTransforms(float alpha);
+    // Model transform of a sub cube (indexed by its home slot)
+    const Transform& GetTransform(int subCube) const;
+
+    // Queue a move, returns false (and drops it) if the queue is full
+    bool QueueMove(Move move);
+    // Drop every queued move, the active one still finishes
+    void ClearQueue();
+    // Number of moves waiting behind the active one
+    int QueuedMoves() const;
+    // True while a move is being animated
+    bool IsRotating() const;
+    // Number of moves that have finished animating
+    long long CompletedMoves() const;
+    // Logical state after every finished move
+    const CubeState& GetCubeState() const;
+    // Logical state once the active move and every queued move have finished
+    CubeState GetQueuedState() const;
+    // Zobrist hash of the logical state, kept up to date move by move
+    uint64_t GetStateHash() const;
+    // Times the current state has been reached since visits started being
+    // counted, which counts as one, 0 while they are not counted
+    int GetStateVisits() const;
+    // Number of different states reached while visits were counted
+    size_t DistinctStates() const;
+    // Count visits of every state reached. Off by default: the table keeps
+    // one entry per distinct state and grows without bound, so only
+    // headless runs that report it should turn it on. Turning it on or off
+    // forgets the visits so far.
+    void SetCountStateVisits(bool count);
+    bool GetCountStateVisits() const;
+
+    // Seconds a quarter turn takes, clamped to the limits above
+    void SetTurnDuration(float seconds);
+    float GetTurnDuration() const;
+    // When set, queued moves speed up as the backlog grows
+    void SetCollapseQueuedMoves(bool collapse);
+    bool GetCollapseQueuedMoves() const;
+
+private:
+    // when rotation is finished, update cubeState and sub cube orientations
+    void FinishMove();
+    // how much faster than normal the active move turns
+    float GetSpeedMultiplier() const;
+
+    // logical cube, answers which sub cube is at each absolute position
+    CubeState m_cubeState;
+    uint64_t m_stateHash;
+    // visits of every state reached, keyed by its hash, empty unless
+    // m_countStateVisits is set
+    TranspositionTable<int> m_stateVisits;
+    bool m_countStateVisits;
+    // moves waiting to be animated
+    MoveQueue m_moveQueue;
+    // move being animated, only valid while rotating
+    Move m_activeMove;
+    bool m_rotating;
+    // radians the active move has turned after the last two steps
+    float m_previousAngle;
+    float m_rotationAngle;
+    // seconds a quarter turn takes
+    float m_turnDuration;
+    bool m_collapseQueuedMoves;
+    long long m_completedMoves;
+    // model transform and finished-turn orientation of every sub cube
+    Transform m_transforms[NUM_SUB_CUBES];
+};
+
+#endif
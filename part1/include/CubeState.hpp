@@ -0,0 +1,108 @@
+/** @file CubeState.hpp
+ *  @brief Compact cubie-level state of the 3x3x3 cube.
+ *
+ *  Stores the permutation and orientation of every edge, corner and
+ *  center in 32 packed bytes. Has no SDL or OpenGL dependency, so the
+ *  cube logic can be driven outside of the window loop.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef CUBESTATE_HPP
+#define CUBESTATE_HPP
+
+#include <cstdint>
+
+// Every turn the engine knows about.
+// Faces and slices follow the usual notation: U/D turn around y, R/L/M
+// around x, F/B/S around z. X/Y/Z turn the whole cube and the W moves
+// turn a face together with its neighbouring slice (Uw, Rw, ...).
+// PRIME is counter-clockwise, 2 is a half turn.
+enum class Move : uint8_t
+{
+    U, U2, U_PRIME,
+    R, R2, R_PRIME,
+    F, F2, F_PRIME,
+    D, D2, D_PRIME,
+    L, L2, L_PRIME,
+    B, B2, B_PRIME,
+    M, M2, M_PRIME,
+    E, E2, E_PRIME,
+    S, S2, S_PRIME,
+    X, X2, X_PRIME,
+    Y, Y2, Y_PRIME,
+    Z, Z2, Z_PRIME,
+    UW, UW2, UW_PRIME,
+    RW, RW2, RW_PRIME,
+    FW, FW2, FW_PRIME,
+    DW, DW2, DW_PRIME,
+    LW, LW2, LW_PRIME,
+    BW, BW2, BW_PRIME
+};
+
+// Purpose:
+// Holds which piece sits in every position of the cube and how it is
+// twisted. Each byte is a piece index with its orientation packed into the
+// high bits. Edges live in the first 16 bytes and corners + centers in the
+// second 16 bytes, so a move never moves a byte across a 16 byte lane.
+class CubeState{
+public:
+    static const int NUM_EDGES = 12;
+    static const int NUM_CORNERS = 8;
+    static const int NUM_CENTERS = 6;
+    static const int NUM_MOVES = 54;
+    // the outer face turns come first (U..B_PRIME)
+    static const int NUM_FACE_MOVES = 18;
+    // number of sub cubes the renderer draws (9*3)
+    static const int NUM_SLOTS = 27;
+    // byte offsets of each piece type in the packed state
+    static const int EDGE_OFFSET = 0;
+    static const int CORNER_OFFSET = 16;
+    static const int CENTER_OFFSET = 24;
+    static const int PACKED_SIZE = 32;
+
+    // Constructor, starts out solved
+    CubeState();
+    // Put every piece back in its home position
+    void Reset();
+    // Apply a single move
+    void ApplyMove(Move move);
+    // True if every piece is home and untwisted (center spin included)
+    bool IsSolved() const;
+    // True if every piece is home and untwisted, however the centers are
+    // spun (spin can not be seen on a real cube)
+    bool IsSolvedIgnoringCenterSpin() const;
+
+    // Piece and orientation lookups by position
+    int EdgePiece(int position) const;
+    int EdgeOrientation(int position) const;
+    int CornerPiece(int position) const;
+    int CornerOrientation(int position) const;
+    int CenterPiece(int position) const;
+    int CenterOrientation(int position) const;
+    // Put a piece with an orientation at a position, nothing checks the
+    // result is a state real turns can reach
+    void SetEdge(int position, int piece, int orientation);
+    void SetCorner(int position, int piece, int orientation);
+
+    // The renderer indexes sub cubes left-to-right, top-to-bottom,
+    // front-to-back. Returns the home slot of the sub cube that is
+    // currently at the given slot.
+    int CubieAt(int slot) const;
+
+    // Raw packed bytes
+    const uint8_t* Data() const;
+
+    bool operator==(const CubeState& other) const;
+    bool operator!=(const CubeState& other) const;
+
+    // the batch API works on the packed bytes directly
+    friend class CubeBatch;
+
+private:
+    // packed pieces, see the layout notes above
+    // (32 byte aligned so a whole state is one AVX2 register)
+    alignas(32) uint8_t m_cubies[PACKED_SIZE];
+};
+
+#endif
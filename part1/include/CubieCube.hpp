@@ -0,0 +1,66 @@
+/** @file CubieCube.hpp
+ *  @brief Unpacked corner and edge state shared by the solvers.
+ *
+ *  The solvers index pieces by permutation and orientation arrays rather
+ *  than the packed bytes of CubeState. This holds those arrays and the
+ *  helpers every solver needs: move composition, permutation ranks,
+ *  solvability and bringing the centers home.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef CUBIECUBE_HPP
+#define CUBIECUBE_HPP
+
+#include <cstdint>
+#include <vector>
+#include "CubeState.hpp"
+
+struct CubieCube{
+    // piece at every position and its orientation, Kociemba's numbering.
+    // Corner orientations 3..5 only occur in mirrored cubes, see Symmetry.
+    uint8_t cp[CubeState::NUM_CORNERS];
+    uint8_t co[CubeState::NUM_CORNERS];
+    uint8_t ep[CubeState::NUM_EDGES];
+    uint8_t eo[CubeState::NUM_EDGES];
+
+    // corners and edges of a state, centers are dropped
+    static CubieCube FromState(const CubeState& state);
+    // the state with these corners and edges and every center home
+    CubeState ToState() const;
+    static CubieCube Solved();
+    // cubies of a face turn (0 = U ... 17 = B'), read off the cube engine
+    static const CubieCube& FaceMove(int move);
+
+    // this cube followed by other, same rule as CubeState::ApplyMove
+    CubieCube Multiply(const CubieCube& other) const;
+    // the cube that undoes this one, Multiply of the two is solved
+    CubieCube Inverse() const;
+    // true if the pieces could come from a real cube (twist, flip and parity)
+    bool IsSolvable() const;
+
+    // * coordinates, all of them are 0 for the solved cube
+    // corner orientations, 0..3^7-1 (the last corner follows from the others)
+    int Twist() const;
+    void SetTwist(int twist);
+    // edge orientations, 0..2^11-1
+    int Flip() const;
+    void SetFlip(int flip);
+    // corner permutation, 0..8!-1
+    int CornerPerm() const;
+    void SetCornerPerm(int index);
+
+    // n choose k, 0 if k is out of range
+    static int Choose(int n, int k);
+    // Lehmer code of a permutation of 0..n-1, 0 for the identity
+    static int PermIndex(const uint8_t* values, int n);
+    // inverse of PermIndex, offset is added to every value
+    static void SetPerm(uint8_t* values, int n, int index, int offset);
+
+    // The fewest whole cube rotations, at most two, that bring every
+    // center home, false if there are none (the centers were not moved by
+    // real turns)
+    static bool FindCenterRotations(const CubeState& state, std::vector<Move>& rotations);
+};
+
+#endif
@@ -0,0 +1,54 @@
+/** @file Goal.hpp
+ *  @brief What a solve should end in, when that is not the solved cube.
+ *
+ *  A goal is a target state (a pattern like the checkerboard or the
+ *  superflip) and masks of the pieces that matter, so partial goals like
+ *  the cross only ask for some pieces to end up where the target has them
+ *  and leave the rest anywhere.
+ *
+ *  Reaching target T from state S takes the same moves as solving
+ *  T^-1 * S, and a piece T has at position i is in place exactly when
+ *  position i of T^-1 * S is solved. So solvers only ever solve, and
+ *  their pruning tables serve every target.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef GOAL_HPP
+#define GOAL_HPP
+
+#include <string>
+#include <vector>
+#include "CubieCube.hpp"
+
+struct Goal{
+    static const int ALL_CORNERS = (1 << CubeState::NUM_CORNERS) - 1;
+    static const int ALL_EDGES = (1 << CubeState::NUM_EDGES) - 1;
+
+    CubieCube target;
+    // bit i asks for the piece the target has at corner (edge) position i,
+    // pieces left out may end up anywhere
+    int cornerMask;
+    int edgeMask;
+
+    // The solved cube, every piece
+    static Goal Solved();
+    // Every piece of the state a move sequence makes from the solved cube.
+    // Whole cube rotations and slice turns count as the face turns they
+    // amount to, the centers stay home.
+    static Goal FromMoves(const std::vector<Move>& moves);
+    // A named pattern or partial goal, see Names. False if there is none.
+    static bool FromName(const std::string& name, Goal& goal);
+    // Names FromName knows
+    static const std::vector<std::string>& Names();
+
+    // True if every piece matters
+    bool IsComplete() const;
+    // The cube that has to be solved instead: target^-1 * cube.
+    // Its positions in the masks are solved once cube reaches the goal.
+    CubieCube Relative(const CubieCube& cube) const;
+    // True if cube (centers home) has every piece the goal asks for in place
+    bool IsReachedBy(const CubieCube& cube) const;
+};
+
+#endif
@@ -0,0 +1,38 @@
+/** @file LastLayerTable.hpp
+ *  @brief An algorithm for every last layer case, looked up in one step.
+ *
+ *  Once the first two layers are solved, the last layer is the order and
+ *  orientation of the four U corners and four U edges: 4! * 3^3 * 4! * 2^3
+ *  states, half of them with matching parities, 62,208 cases in all. The
+ *  signature of a case numbers them 0..62207 with no gaps (0 is solved),
+ *  the case number of the table. Every algorithm keeps the first two
+ *  layers and ends with the U face in place, so one lookup solves the
+ *  whole last layer.
+ *
+ *  Tables are filled offline (see CfopSolver) and saved to an
+ *  AlgorithmTable file of about a megabyte.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef LASTLAYERTABLE_HPP
+#define LASTLAYERTABLE_HPP
+
+#include "AlgorithmTable.hpp"
+#include "CubieCube.hpp"
+
+class LastLayerTable : public AlgorithmTable{
+public:
+    // 4! corner orders * 3^3 twists * 4!/2 edge orders * 2^3 flips
+    static const int NUM_CASES = 62208;
+
+    // Constructor, no algorithms until Reset or Load
+    LastLayerTable();
+
+    // Case of a cube whose first two layers are solved, 0 if it is solved
+    static int Signature(const CubieCube& cube);
+    // The solved cube with the last layer of a case
+    static CubieCube CaseCube(int signature);
+};
+
+#endif
@@ -0,0 +1,111 @@
+/** @file MoveParser.hpp
+ *  @brief Streaming parser for standard cube notation.
+ *
+ *  Understands face turns (U R F D L B), slices (M E S), wide moves
+ *  (Rw or r), rotations (x y z), primes, doubles (R2, R2', R3 ...),
+ *  repetition groups such as (R U R' U')6 or [R U]', commutators [A, B]
+ *  (A B A' B') and conjugates [A: B] (A B A'). Text can be fed in
+ *  chunks of any size, a token may be split across chunks, and moves are
+ *  handed to a sink as soon as they are known. Nothing is allocated per
+ *  token. Every non-empty line is one sequence, // starts a comment.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef MOVEPARSER_HPP
+#define MOVEPARSER_HPP
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+#include "CubeState.hpp"
+
+class MoveParser{
+public:
+    // Receives parsed moves in order
+    class Sink{
+    public:
+        virtual ~Sink(){}
+        // Called for every move
+        virtual void OnMove(Move move) = 0;
+        // Called at the end of every non-empty line
+        virtual void OnSequenceEnd(){}
+    };
+
+    // Sink that appends every move to a vector
+    class VectorSink : public Sink{
+    public:
+        VectorSink(std::vector<Move>& moves):m_moves(moves){}
+        void OnMove(Move move) override{
+            m_moves.push_back(move);
+        }
+    private:
+        std::vector<Move>& m_moves;
+    };
+
+    // Constructor, moves go to the sink
+    MoveParser(Sink& sink);
+    // Parse the next chunk of text, returns false once an error was found
+    bool Feed(const char* text, size_t length);
+    // Flush the last token and sequence, returns false on error
+    bool Finish();
+    // Parse a whole stream in fixed size chunks, calls Finish
+    bool ParseStream(std::istream& in);
+    // Description of the first error, with line and column
+    const std::string& GetError() const;
+
+    // Parse a short sequence into a vector (moves are appended)
+    static bool ParseString(const std::string& text, std::vector<Move>& moves, std::string* error=nullptr);
+    // Notation for a move, e.g. "R'", "Rw2" or "x"
+    static const char* Name(Move move);
+    // Space separated notation for a sequence
+    static std::string ToString(const Move* moves, size_t count);
+    static std::string ToString(const std::vector<Move>& moves);
+
+private:
+    // most moves an open group may expand to
+    static const size_t MAX_GROUP_MOVES = 1 << 24;
+
+    // handle one character, false on error
+    bool ProcessChar(char c);
+    // finish the pending move token and emit it
+    void FlushMove();
+    // finish the pending group suffix and emit the group
+    bool FlushGroup();
+    // send a move to the sink or the innermost open group
+    void Emit(Move move);
+    // record an error at the current position
+    bool Fail(const char* message);
+
+    Sink& m_sink;
+    // pending move token, base is -1 if there is none
+    int m_base;
+    bool m_wide;
+    int m_amount;
+    bool m_prime;
+    // pending group suffix after ')'
+    bool m_groupSuffix;
+    int m_groupAmount;
+    bool m_groupPrime;
+    // comment handling, m_slash is a single '/' seen
+    bool m_slash;
+    bool m_comment;
+    // true once the current line had a token
+    bool m_sequenceStarted;
+    // moves of all open groups, and where each open group starts
+    std::vector<Move> m_groupMoves;
+    std::vector<size_t> m_groupStarts;
+    // for each open group: its bracket, ( or [, and where the ',' or ':'
+    // of a commutator or conjugate split it, if one did
+    std::vector<char> m_groupBrackets;
+    std::vector<size_t> m_groupSeparators;
+    std::vector<char> m_groupSeparatorChars;
+    // position for error messages
+    int m_line;
+    int m_column;
+    bool m_failed;
+    std::string m_error;
+};
+
+#endif
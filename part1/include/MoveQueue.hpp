@@ -0,0 +1,43 @@
+/** @file MoveQueue.hpp
+ *  @brief Bounded first-in first-out queue of moves waiting to be animated.
+ *
+ *  Fixed size ring buffer, pushing and popping never allocates.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef MOVEQUEUE_HPP
+#define MOVEQUEUE_HPP
+
+#include "CubeState.hpp"
+
+class MoveQueue{
+public:
+    // most moves that can wait at once
+    static const int CAPACITY = 256;
+
+    // Constructor, starts out empty
+    MoveQueue();
+    // Add a move to the back, returns false (and drops it) if full
+    bool Push(Move move);
+    // Take the move at the front, returns false if empty
+    bool Pop(Move& move);
+    // Move at a position without removing it, 0 is the front
+    Move Peek(int index) const;
+    // Drop every waiting move
+    void Clear();
+    // Number of waiting moves
+    int Size() const;
+    bool Empty() const;
+    bool Full() const;
+
+private:
+    // ring buffer of waiting moves
+    Move m_moves[CAPACITY];
+    // index of the front move
+    int m_head;
+    // number of waiting moves
+    int m_size;
+};
+
+#endif
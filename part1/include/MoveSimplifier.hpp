@@ -0,0 +1,73 @@
+/** @file MoveSimplifier.hpp
+ *  @brief Cancels, merges and canonically orders move sequences.
+ *
+ *  Moves around the same axis commute, so a run of them is just a number
+ *  of quarter turns for each of the three layers. Runs are kept on a
+ *  stack, a run that cancels out is popped so its neighbours can merge,
+ *  and every run is written back as the cheapest moves in the chosen
+ *  metric, in a fixed order. Each move is handled in constant time.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef MOVESIMPLIFIER_HPP
+#define MOVESIMPLIFIER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "CubeState.hpp"
+
+class MoveSimplifier{
+public:
+    // How moves are counted. Rotations and wide turns count like an outer
+    // turn since they take as long to animate, so the metrics are the
+    // usual ones with those two added as single turns.
+    enum class Metric
+    {
+        // half turn metric, no slices: a slice is written as an outer
+        // turn and the wide turn that undoes it (M is R Rw'), two turns
+        HTM,
+        // quarter turn metric, half turns count twice, slices are written
+        // as in HTM
+        QTM,
+        // slice turn metric, slices count as one turn
+        STM
+    };
+
+    // Constructor, starts out with an empty sequence
+    MoveSimplifier(Metric metric = Metric::STM);
+    // Append a move to the sequence
+    void Push(Move move);
+    void Push(const Move* moves, size_t count);
+    // Forget the sequence
+    void Clear();
+    // Append the simplified sequence to moves
+    void Write(std::vector<Move>& moves) const;
+    // Turns in the simplified sequence
+    int Cost() const;
+
+    // Simplify a sequence in place
+    static void Simplify(std::vector<Move>& moves, Metric metric = Metric::STM);
+    // Turns a sequence takes in a metric
+    static int Cost(const Move* moves, size_t count, Metric metric);
+    static int Cost(const std::vector<Move>& moves, Metric metric);
+    // Metric from "htm", "qtm" or "stm", returns false if unknown
+    static bool ParseMetric(const std::string& name, Metric& metric);
+    static const char* Name(Metric metric);
+
+private:
+    // moves around one axis, as quarter turns per layer
+    struct Run{
+        uint8_t axis;
+        // counter-clockwise quarter turns around +axis of the layers
+        // at coordinate -1, 0 and 1
+        uint8_t layers[3];
+    };
+
+    Metric m_metric;
+    // runs in order, neighbours always turn around different axes
+    std::vector<Run> m_runs;
+};
+
+#endif
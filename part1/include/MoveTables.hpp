@@ -0,0 +1,280 @@
+/** @file MoveTables.hpp
+ *  @brief Move tables for every turn, generated at compile time.
+ *
+ *  All tables come from one geometric definition: where each piece sits
+ *  in space and which layers a move turns around which axis. Nothing is
+ *  built at runtime.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef MOVETABLES_HPP
+#define MOVETABLES_HPP
+
+#include <cstdint>
+#include "CubeState.hpp"
+
+namespace MoveTables{
+    // * cube geometry, x = right, y = up, z = towards the front (white) face
+    // edges: UR UF UL UB DR DF DL DB FR FL BL BR
+    inline constexpr int EDGE_POS[CubeState::NUM_EDGES][3] = {
+        {1,1,0}, {0,1,1}, {-1,1,0}, {0,1,-1},
+        {1,-1,0}, {0,-1,1}, {-1,-1,0}, {0,-1,-1},
+        {1,0,1}, {-1,0,1}, {-1,0,-1}, {1,0,-1}
+    };
+    // corners: URF UFL ULB UBR DFR DLF DBL DRB
+    inline constexpr int CORNER_POS[CubeState::NUM_CORNERS][3] = {
+        {1,1,1}, {-1,1,1}, {-1,1,-1}, {1,1,-1},
+        {1,-1,1}, {-1,-1,1}, {-1,-1,-1}, {1,-1,-1}
+    };
+    // centers: U R F D L B
+    inline constexpr int CENTER_POS[CubeState::NUM_CENTERS][3] = {
+        {0,1,0}, {1,0,0}, {0,0,1}, {0,-1,0}, {-1,0,0}, {0,0,-1}
+    };
+
+    // a quarter turn of one or more layers around an axis
+    struct MoveDefinition{
+        // 0 = x, 1 = y, 2 = z
+        int axis;
+        // bit (coordinate+1) is set for every layer that turns
+        int layers;
+        // counter-clockwise quarter turns around +axis for one turn
+        int turns;
+    };
+    // one entry per group of three moves in the Move enum
+    inline constexpr int NUM_BASE_MOVES = CubeState::NUM_MOVES/3;
+    inline constexpr MoveDefinition BASE_MOVES[NUM_BASE_MOVES] = {
+        // U R F D L B
+        {1, 4, -1}, {0, 4, -1}, {2, 4, -1},
+        {1, 1,  1}, {0, 1,  1}, {2, 1,  1},
+        // M E S follow L, D and F
+        {0, 2,  1}, {1, 2,  1}, {2, 2, -1},
+        // x y z follow R, U and F
+        {0, 7, -1}, {1, 7, -1}, {2, 7, -1},
+        // Uw Rw Fw Dw Lw Bw
+        {1, 6, -1}, {0, 6, -1}, {2, 6, -1},
+        {1, 3,  1}, {0, 3,  1}, {2, 3,  1}
+    };
+
+    // new[i] = (old[perm[i]] + add[i]) wrapped to the piece's orientation range
+    struct MoveTable{
+        uint8_t perm[CubeState::PACKED_SIZE];
+        uint8_t add[CubeState::PACKED_SIZE];
+    };
+
+    struct Tables{
+        MoveTable moves[CubeState::NUM_MOVES];
+        // home slot of every piece, used to answer CubieAt
+        uint8_t edgeSlot[CubeState::NUM_EDGES];
+        uint8_t cornerSlot[CubeState::NUM_CORNERS];
+        uint8_t centerSlot[CubeState::NUM_CENTERS];
+        // byte in the packed state for every slot, -1 for the core
+        int8_t slotByte[CubeState::NUM_SLOTS];
+    };
+
+    // integer vector, only used while generating tables
+    struct Vec3{
+        int v[3];
+    };
+
+    constexpr Vec3 MakeVec3(const int (&p)[3]){
+        return Vec3{{p[0], p[1], p[2]}};
+    }
+
+    constexpr bool Equal(const Vec3& a, const Vec3& b){
+        return a.v[0]==b.v[0] && a.v[1]==b.v[1] && a.v[2]==b.v[2];
+    }
+
+    // rotate counter-clockwise around +axis by a number of quarter turns
+    constexpr Vec3 RotateQuarter(Vec3 p, int axis, int turns){
+        turns = ((turns % 4) + 4) % 4;
+        int a = (axis+1) % 3;
+        int b = (axis+2) % 3;
+        for (int i=0; i<turns; i++){
+            int tmp = p.v[a];
+            p.v[a] = -p.v[b];
+            p.v[b] = tmp;
+        }
+        return p;
+    }
+
+    // renderer slot of a position in space
+    // (left-to-right, top-to-bottom, front-to-back)
+    constexpr int SlotIndex(const Vec3& p){
+        return (1-p.v[1])*3 + (p.v[0]+1) + (1-p.v[2])*9;
+    }
+
+    // position in space of a renderer slot
+    constexpr Vec3 SlotPosition(int slot){
+        return Vec3{{slot%3 - 1, 1 - (slot/3)%3, 1 - slot/9}};
+    }
+
+    // corner facelet normals: U/D first, then the others clockwise
+    constexpr Vec3 CornerFacelet(const Vec3& c, int i){
+        // up . (side x front) = -x*y*z, -1 means side comes first clockwise
+        bool sideFirst = c.v[0]*c.v[1]*c.v[2] == 1;
+        if (i == 0){
+            return Vec3{{0, c.v[1], 0}};
+        }
+        if ((i == 1) == sideFirst){
+            return Vec3{{c.v[0], 0, 0}};
+        }
+        return Vec3{{0, 0, c.v[2]}};
+    }
+
+    // edge facelet normals: U/D first, or F/B for middle layer edges
+    constexpr Vec3 EdgeFacelet(const Vec3& c, int i){
+        if (c.v[1] != 0){
+            if (i == 0){
+                return Vec3{{0, c.v[1], 0}};
+            }
+            return c.v[0] != 0 ? Vec3{{c.v[0], 0, 0}} : Vec3{{0, 0, c.v[2]}};
+        }
+        return i == 0 ? Vec3{{0, 0, c.v[2]}} : Vec3{{c.v[0], 0, 0}};
+    }
+
+    // reference direction on a center used to measure its spin
+    constexpr Vec3 CenterTangent(const Vec3& c){
+        return c.v[1] != 0 ? Vec3{{0, 0, 1}} : Vec3{{0, 1, 0}};
+    }
+
+    template<int N>
+    constexpr int Find(const int (&list)[N][3], const Vec3& p){
+        for (int i=0; i<N; i++){
+            if (Equal(MakeVec3(list[i]), p)){
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    constexpr bool InLayers(const MoveDefinition& def, const Vec3& p){
+        return (def.layers & (1 << (p.v[def.axis]+1))) != 0;
+    }
+
+    constexpr MoveTable BuildMoveTable(const MoveDefinition& def, int power){
+        MoveTable table{};
+        int turns = def.turns*power;
+        for (int i=0; i<CubeState::PACKED_SIZE; i++){
+            table.perm[i] = i;
+        }
+
+        for (int s=0; s<CubeState::NUM_EDGES; s++){
+            Vec3 from = MakeVec3(EDGE_POS[s]);
+            if (!InLayers(def, from)) continue;
+            Vec3 to = RotateQuarter(from, def.axis, turns);
+            int t = Find(EDGE_POS, to);
+            Vec3 facelet = RotateQuarter(EdgeFacelet(from, 0), def.axis, turns);
+            table.perm[CubeState::EDGE_OFFSET+t] = CubeState::EDGE_OFFSET+s;
+            table.add[CubeState::EDGE_OFFSET+t] = Equal(EdgeFacelet(to, 0), facelet) ? 0 : (1 << 4);
+        }
+
+        for (int s=0; s<CubeState::NUM_CORNERS; s++){
+            Vec3 from = MakeVec3(CORNER_POS[s]);
+            if (!InLayers(def, from)) continue;
+            Vec3 to = RotateQuarter(from, def.axis, turns);
+            int t = Find(CORNER_POS, to);
+            Vec3 facelet = RotateQuarter(CornerFacelet(from, 0), def.axis, turns);
+            int twist = 0;
+            while (!Equal(CornerFacelet(to, twist), facelet)){
+                twist++;
+            }
+            table.perm[CubeState::CORNER_OFFSET+t] = CubeState::CORNER_OFFSET+s;
+            table.add[CubeState::CORNER_OFFSET+t] = twist << 3;
+        }
+
+        for (int s=0; s<CubeState::NUM_CENTERS; s++){
+            Vec3 from = MakeVec3(CENTER_POS[s]);
+            if (!InLayers(def, from)) continue;
+            Vec3 to = RotateQuarter(from, def.axis, turns);
+            int t = Find(CENTER_POS, to);
+            Vec3 moved = RotateQuarter(CenterTangent(from), def.axis, turns);
+            Vec3 home = CenterTangent(to);
+            // count clockwise quarter turns (seen from outside) from home to moved
+            int axis = to.v[0] != 0 ? 0 : (to.v[1] != 0 ? 1 : 2);
+            int spin = 0;
+            while (!Equal(home, moved)){
+                home = RotateQuarter(home, axis, -to.v[axis]);
+                spin++;
+            }
+            table.perm[CubeState::CENTER_OFFSET+t] = CubeState::CENTER_OFFSET+s;
+            table.add[CubeState::CENTER_OFFSET+t] = spin << 3;
+        }
+        return table;
+    }
+
+    constexpr Tables BuildTables(){
+        Tables tables{};
+        for (int m=0; m<CubeState::NUM_MOVES; m++){
+            tables.moves[m] = BuildMoveTable(BASE_MOVES[m/3], m%3 + 1);
+        }
+        for (int i=0; i<CubeState::NUM_SLOTS; i++){
+            tables.slotByte[i] = -1;
+        }
+        for (int i=0; i<CubeState::NUM_EDGES; i++){
+            tables.edgeSlot[i] = SlotIndex(MakeVec3(EDGE_POS[i]));
+            tables.slotByte[tables.edgeSlot[i]] = CubeState::EDGE_OFFSET+i;
+        }
+        for (int i=0; i<CubeState::NUM_CORNERS; i++){
+            tables.cornerSlot[i] = SlotIndex(MakeVec3(CORNER_POS[i]));
+            tables.slotByte[tables.cornerSlot[i]] = CubeState::CORNER_OFFSET+i;
+        }
+        for (int i=0; i<CubeState::NUM_CENTERS; i++){
+            tables.centerSlot[i] = SlotIndex(MakeVec3(CENTER_POS[i]));
+            tables.slotByte[tables.centerSlot[i]] = CubeState::CENTER_OFFSET+i;
+        }
+        return tables;
+    }
+
+    inline constexpr Tables TABLES = BuildTables();
+
+    // * helpers for turning moves into animation parameters
+    // axis a move turns around, 0 = x, 1 = y, 2 = z
+    constexpr int Axis(Move move){
+        return BASE_MOVES[static_cast<int>(move)/3].axis;
+    }
+
+    // counter-clockwise quarter turns around +axis, in [-2, 2]
+    constexpr int QuarterTurns(Move move){
+        int power = static_cast<int>(move)%3 + 1;
+        int turns = ((BASE_MOVES[static_cast<int>(move)/3].turns*power % 4) + 4) % 4;
+        return turns > 2 ? turns-4 : turns;
+    }
+
+    // true if the sub cube at a renderer slot turns with the move
+    constexpr bool MovesSlot(Move move, int slot){
+        return InLayers(BASE_MOVES[static_cast<int>(move)/3], SlotPosition(slot));
+    }
+
+    // move from a base move (0 = U ... 17 = Bw) and power (1, 2 or 3 = prime)
+    constexpr Move MakeMove(int base, int power){
+        return static_cast<Move>(base*3 + power-1);
+    }
+
+    constexpr int BaseMove(Move move){
+        return static_cast<int>(move)/3;
+    }
+
+    constexpr int Power(Move move){
+        return static_cast<int>(move)%3 + 1;
+    }
+
+    constexpr Move Inverse(Move move){
+        return MakeMove(BaseMove(move), 4-Power(move));
+    }
+
+    // * search pruning for face turns (0 = U ... 17 = B')
+    // true if a face turn never needs to follow previous: turning the same
+    // face twice, or opposite faces in the wrong order (U D and D U are the
+    // same), previous < 0 means there is none
+    constexpr bool RedundantFaceTurn(int move, int previous){
+        if (previous < 0){
+            return false;
+        }
+        int face = move/3;
+        int previousFace = previous/3;
+        return face == previousFace || face + 3 == previousFace;
+    }
+}
+
+#endif
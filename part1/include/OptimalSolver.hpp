@@ -0,0 +1,165 @@
+/** @file OptimalSolver.hpp
+ *  @brief Finds the shortest possible solution with IDA* (Korf's method).
+ *
+ *  Iterative deepening A* with the largest of three admissible estimates:
+ *  a pattern database for all corners and two for disjoint sets of six
+ *  edges. The corner one only holds a representative of every class of
+ *  states that are symmetric by the 16 symmetries keeping the U-D axis,
+ *  a sixteenth of the size. Redundant move orders (the same face twice, opposite faces in
+ *  both orders) are never searched. Optimal means fewest face turns,
+ *  half turns count as one.
+ *
+ *  With several threads each iteration is split into tasks a few moves
+ *  below the root, which a small work stealing pool searches. The first
+ *  solution in move order wins, so the result does not depend on the
+ *  number of threads.
+ *
+ *  The pattern databases take a while to generate, so the pdbgen tool
+ *  writes them to a directory once and the solver maps them from there.
+ *
+ *  Goals other than the solved cube (see Goal) are solved relative to
+ *  their target with the same databases. Partial goals use the databases
+ *  whose pieces they keep, and how far each piece they keep is from home.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef OPTIMALSOLVER_HPP
+#define OPTIMALSOLVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CubeState.hpp"
+#include "Goal.hpp"
+#include "PatternDatabase.hpp"
+#include "Symmetry.hpp"
+
+class OptimalSolver{
+public:
+    // corner permutation classes * 3^7 twists, instead of 8! * 3^7
+    static const uint64_t NUM_CORNER_STATES = uint64_t(Symmetry::NUM_CORNER_CLASSES)*2187;
+    // edges in each edge pattern
+    static const int PATTERN_EDGES = 6;
+    // 12!/6! positions * 2^6 flips of six edges
+    static const uint64_t NUM_EDGE_STATES = 42577920;
+    // no cube needs more than 20 face turns
+    static const int MAX_LENGTH = 20;
+    // the corner pattern database and the two edge ones
+    static const int NUM_TABLES = 3;
+    // moves below the root where a parallel search splits into tasks
+    static const int SPLIT_DEPTH = 3;
+
+    // What a search did, for sizing machines
+    struct Statistics{
+        // nodes generated in total and in the iteration with each depth bound
+        long long nodes = 0;
+        std::vector<long long> nodesPerIteration;
+        double seconds = 0.0;
+        double NodesPerSecond() const;
+    };
+
+    // Constructor, maps the pattern databases from files in tableDirectory
+    // and generates any that are missing there (takes a while) with
+    // threads threads, 0 means one per core. An empty directory always
+    // generates.
+    OptimalSolver(const std::string& tableDirectory = "", int threads = 0);
+
+    // Find a shortest solution for state, written to solution. Whole cube
+    // rotations come first if the centers are not home and are not
+    // counted. Center spin is ignored. Returns false if the state can not
+    // be solved in maxLength face turns. Searches with threads threads,
+    // 0 means one per core. Safe to call from several threads.
+    bool Solve(const CubeState& state, std::vector<Move>& solution,
+               Statistics* statistics = nullptr, int maxLength = MAX_LENGTH, int threads = 1) const;
+
+    // Find a shortest way from state to goal, the same way as Solve.
+    // Threads only split searches for goals that keep every piece.
+    bool Solve(const CubeState& state, const Goal& goal, std::vector<Move>& solution,
+               Statistics* statistics = nullptr, int maxLength = MAX_LENGTH, int threads = 1) const;
+
+    // Lower bound on the face turns a state needs, centers must be home
+    int Estimate(const CubeState& state) const;
+    // Bytes of memory the pattern databases and move tables take
+    size_t MemoryFootprint() const;
+
+    // A pattern database, 0 is the corners, 1 and 2 the edges
+    const PatternDatabase& Table(int table) const;
+    // Name of a pattern database, also its file name without .pdb
+    static const char* TableName(int table);
+    // Number of pattern databases that were mapped from files
+    int TablesLoaded() const;
+    // Write every pattern database to tableDirectory, which must exist
+    bool SaveTables(const std::string& tableDirectory) const;
+
+private:
+    // search state: coordinates for the corners, and position * 2 + flip
+    // of every edge, edge pieces 0-5 and 6-11 make up the two patterns
+    struct Node{
+        uint16_t cornerPerm;
+        uint16_t twist;
+        uint8_t edges[CubeState::NUM_EDGES];
+    };
+    struct Search;
+    // subtree at SPLIT_DEPTH for a parallel search
+    struct Task;
+    // threads that search the tasks of every parallel iteration of a Solve
+    struct Pool;
+    // node of a partial goal search, which also follows every corner as
+    // position * 3 + twist to see which corners are home
+    struct GoalNode{
+        Node node;
+        uint8_t corners[CubeState::NUM_CORNERS];
+    };
+
+    static std::string TablePath(const std::string& tableDirectory, int table);
+    static uint64_t TableSize(int table);
+
+    // corner pattern database entry: the corners conjugated to their class
+    uint64_t CornerIndex(int cornerPerm, int twist) const{
+        return uint64_t(m_cornerClass[cornerPerm])*2187
+             + m_twistConjugate[twist*Symmetry::NUM_UD_SYMMETRIES + m_cornerClassSymmetry[cornerPerm]];
+    }
+    Node MakeNode(const CubieCube& cube) const;
+    Node ApplyMove(const Node& node, int move) const;
+    int Estimate(const Node& node) const;
+    // Solve once the centers are home, rotations go in front of the solution
+    bool SolveCubies(const CubieCube& cube, const std::vector<Move>& rotations, std::vector<Move>& solution,
+                     Statistics* statistics, int maxLength, int threads) const;
+    // depth first search below a node whose estimate is already known
+    bool Search(struct Search& search, const Node& node, int depth, int bound, int estimate) const;
+    // every node at SPLIT_DEPTH within the bound, in the order Search visits them
+    void SplitTasks(struct Search& search, const Node& node, int depth, int bound, int estimate,
+                    std::vector<Task>& tasks) const;
+    // one iteration of Search split over the pool, same result and moves
+    bool SearchParallel(struct Search& search, Pool& pool, const Node& root, int bound, int estimate) const;
+    // Search for a goal that keeps the pieces in the masks, 0 once they are home
+    GoalNode ApplyMove(const GoalNode& node, int move) const;
+    int GoalEstimate(const GoalNode& node, int cornerMask, int edgeMask) const;
+    bool SearchGoal(struct Search& search, const GoalNode& node, int cornerMask, int edgeMask,
+                    int depth, int bound, int estimate) const;
+
+    // coordinate after a move, indexed [coordinate*NUM_FACE_MOVES + move]
+    std::vector<uint16_t> m_cornerPermMove;
+    std::vector<uint16_t> m_twistMove;
+    // position * 2 + flip of an edge after a move
+    uint8_t m_edgeMove[CubeState::NUM_EDGES*2][CubeState::NUM_FACE_MOVES];
+    // position * 3 + twist of a corner after a move
+    uint8_t m_cornerMove[CubeState::NUM_CORNERS*3][CubeState::NUM_FACE_MOVES];
+    // fewest face turns that bring piece i home from position * 3 + twist
+    // (position * 2 + flip), for partial goals
+    uint8_t m_cornerDistance[CubeState::NUM_CORNERS][CubeState::NUM_CORNERS*3];
+    uint8_t m_edgeDistance[CubeState::NUM_EDGES][CubeState::NUM_EDGES*2];
+    // copies of the Symmetry tables CornerIndex reads, for every node
+    std::vector<uint16_t> m_cornerClass;
+    std::vector<uint8_t> m_cornerClassSymmetry;
+    std::vector<uint16_t> m_twistConjugate;
+
+    PatternDatabase m_corners;
+    // edge pieces 0-5 and 6-11
+    PatternDatabase m_edges[2];
+    int m_tablesLoaded;
+};
+
+#endif
@@ -0,0 +1,180 @@
+/** @file PatternDatabase.hpp
+ *  @brief Distance table packed at two entries per byte.
+ *
+ *  A pattern database stores, for every index of some coordinate space
+ *  (the corners, or a subset of the edges), the fewest face turns that
+ *  solve that part of the cube. Distances never exceed 14 here, so each
+ *  entry is 4 bits and 15 marks an entry that is not known yet.
+ *
+ *  Tables are generated in memory by a breadth first search split over
+ *  threads, and can be saved to a versioned file. Loading a file maps it
+ *  read only, so every solver process on a machine shares the same pages
+ *  and only the first one to touch an entry pays for reading it.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef PATTERNDATABASE_HPP
+#define PATTERNDATABASE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+class PatternDatabase{
+public:
+    // value of entries that have not been reached
+    static const int UNKNOWN = 15;
+    // bumped whenever the file layout or an index encoding changes
+    static const uint32_t FILE_VERSION = 2;
+    // entries start here in a file, page aligned for mapping
+    static const uint64_t FILE_DATA_OFFSET = 4096;
+    // most indices Generate takes from one neighbors call: 18 face turns
+    // times up to 16 symmetric copies of each
+    static const int MAX_NEIGHBORS = 18*16;
+
+    // Constructor, empty until Reset or Load
+    PatternDatabase();
+    // Destructor, unmaps a loaded file
+    ~PatternDatabase();
+    // A table may own a file mapping, so it is never copied
+    PatternDatabase(const PatternDatabase&) = delete;
+    PatternDatabase& operator=(const PatternDatabase&) = delete;
+
+    // Resize to a number of entries, all UNKNOWN, held in memory
+    void Reset(uint64_t size);
+
+    // Distance stored at an index (inline, the solvers call this per node)
+    int Get(uint64_t index) const{
+        return (m_data[index >> 1] >> ((index & 1) << 2)) & 0x0F;
+    }
+    // Only for tables made by Reset, a loaded file is read only
+    void Set(uint64_t index, int value);
+    // Start loading the entry into the cache, for reads that come shortly after
+    void Prefetch(uint64_t index) const{
+        __builtin_prefetch(&m_data[index >> 1]);
+    }
+
+    // Number of entries
+    uint64_t Size() const;
+    // Bytes of memory the entries take
+    size_t Bytes() const;
+    // True if the entries are a read only mapping of a file
+    bool IsMapped() const;
+    // Number of entries at each distance, UNKNOWN last
+    std::vector<uint64_t> DepthCounts() const;
+
+    // Fill every entry by breadth first search from the goal index.
+    // neighbors(index, out) writes the index after each of the 18 face
+    // turns to out and returns how many it wrote. Symmetry reduced tables
+    // write every index of the same state too, they all get the same
+    // distance. Each depth is split
+    // over threads (0 means one per core), neighbors must be thread safe.
+    template<typename Neighbors>
+    void Generate(uint64_t goal, Neighbors neighbors, int threads = 1);
+
+    // Write the entries to a file, name says which table it is.
+    // Returns false and prints why if the file can not be written.
+    bool Save(const std::string& path, const std::string& name) const;
+    // Use the entries of a file written by Save. Fails without a message
+    // if there is no file, and with one if it is not the table expected:
+    // another name, size or version.
+    bool Load(const std::string& path, const std::string& name, uint64_t size);
+
+private:
+    // what a file starts with, the rest of the first page is zero
+    struct FileHeader{
+        char magic[8];
+        uint32_t version;
+        uint32_t bitsPerEntry;
+        uint64_t entries;
+        char name[32];
+        uint64_t dataOffset;
+    };
+    static FileHeader MakeHeader(const std::string& name, uint64_t size);
+
+    // Entry access that is safe while other threads generate the table
+    int GetShared(uint64_t index) const{
+        return (__atomic_load_n(&m_data[index >> 1], __ATOMIC_RELAXED) >> ((index & 1) << 2)) & 0x0F;
+    }
+    // Set an UNKNOWN entry, false if it already holds a distance
+    bool Claim(uint64_t index, int value);
+
+    void Unmap();
+
+    // entries of a table that is generated in memory
+    std::vector<uint8_t> m_nibbles;
+    // the entries in use, m_nibbles or part of a file mapping
+    const uint8_t* m_data;
+    uint64_t m_size;
+    // the whole mapped file, nullptr if nothing is mapped
+    void* m_mapping;
+    size_t m_mappingBytes;
+};
+
+template<typename Neighbors>
+void PatternDatabase::Generate(uint64_t goal, Neighbors neighbors, int threads){
+    if (threads <= 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    Set(goal, 0);
+    uint64_t filled = 1;
+    for (int depth=0; filled < m_size && depth+1 < UNKNOWN; depth++){
+        // while few entries are known, expand the ones at this depth;
+        // once most are known, it is cheaper to look for unknown entries
+        // with a neighbor at this depth
+        bool forward = filled < m_size/2;
+        // entries only ever change from UNKNOWN to depth+1 during a
+        // depth, so every thread sees the same entries at depth no
+        // matter how the others are getting on
+        std::vector<uint64_t> found(threads, 0);
+        auto expand = [&](int thread){
+            uint64_t out[MAX_NEIGHBORS];
+            uint64_t count = 0;
+            uint64_t end = m_size*(thread+1)/threads;
+            for (uint64_t i=m_size*thread/threads; i<end; i++){
+                int value = GetShared(i);
+                if (forward && value == depth){
+                    int neighborCount = neighbors(i, out);
+                    for (int n=0; n<neighborCount; n++){
+                        if (Claim(out[n], depth+1)){
+                            count++;
+                        }
+                    }
+                } else if (!forward && value == UNKNOWN){
+                    int neighborCount = neighbors(i, out);
+                    for (int n=0; n<neighborCount; n++){
+                        if (GetShared(out[n]) == depth){
+                            Claim(i, depth+1);
+                            count++;
+                            break;
+                        }
+                    }
+                }
+            }
+            found[thread] = count;
+        };
+        std::vector<std::thread> workers;
+        for (int thread=1; thread<threads; thread++){
+            workers.emplace_back(expand, thread);
+        }
+        expand(0);
+        for (std::thread& worker : workers){
+            worker.join();
+        }
+
+        uint64_t before = filled;
+        for (uint64_t count : found){
+            filled += count;
+        }
+        // nothing new means every reachable entry is known
+        if (filled == before){
+            break;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,88 @@
+/** @file Philox.hpp
+ *  @brief Philox4x32-10, a counter based random number generator.
+ *
+ *  Each block of four numbers is ten rounds of multiplying and mixing a
+ *  128 bit counter with a 64 bit key (Salmon et al., "Parallel random
+ *  numbers: as easy as 1, 2, 3"). There is no state besides the counter,
+ *  so stream s of a seed is simply the counters that start with s: any
+ *  number of streams, one per thread or one per generated item, never
+ *  overlap, and any of them can be regenerated on its own.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef PHILOX_HPP
+#define PHILOX_HPP
+
+#include <cstdint>
+
+class Philox{
+public:
+    // Constructor, the first number of a stream of a seed
+    Philox(uint64_t seed, uint64_t stream){
+        m_key[0] = uint32_t(seed);
+        m_key[1] = uint32_t(seed >> 32);
+        m_counter[0] = uint32_t(stream);
+        m_counter[1] = uint32_t(stream >> 32);
+        m_counter[2] = 0;
+        m_counter[3] = 0;
+        m_used = 4;
+    }
+
+    // Next uniformly random 32 bit number
+    uint32_t Next(){
+        if (m_used == 4){
+            Block(m_counter, m_key, m_block);
+            // the low half counts blocks within the stream
+            if (++m_counter[2] == 0){
+                m_counter[3]++;
+            }
+            m_used = 0;
+        }
+        return m_block[m_used++];
+    }
+
+    // Uniformly random number below bound (bound > 0), no modulo bias
+    uint32_t Below(uint32_t bound){
+        // numbers under threshold would make the low results more likely
+        uint32_t threshold = (0u - bound) % bound;
+        for (;;){
+            uint32_t value = Next();
+            if (value >= threshold){
+                return value % bound;
+            }
+        }
+    }
+
+    // The ten rounds on one counter, out gets four numbers
+    static void Block(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]){
+        uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round=0; round<10; round++){
+            uint64_t product0 = uint64_t(0xD2511F53u)*c0;
+            uint64_t product1 = uint64_t(0xCD9E8D57u)*c2;
+            uint32_t next0 = uint32_t(product1 >> 32) ^ c1 ^ k0;
+            uint32_t next2 = uint32_t(product0 >> 32) ^ c3 ^ k1;
+            c1 = uint32_t(product1);
+            c3 = uint32_t(product0);
+            c0 = next0;
+            c2 = next2;
+            // the key is bumped by the golden ratio and sqrt(3)-1 between rounds
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+private:
+    uint32_t m_key[2];
+    uint32_t m_counter[4];
+    // numbers of the current block, m_used of them handed out
+    uint32_t m_block[4];
+    int m_used;
+};
+
+#endif
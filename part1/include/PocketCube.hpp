@@ -0,0 +1,54 @@
+/** @file PocketCube.hpp
+ *  @brief The 2x2x2 cube, as the corners of the 3x3x3 one, enumerated whole.
+ *
+ *  A pocket cube is the eight corners of a big cube with nothing else.
+ *  Keeping the DBL corner in place and turning only U, R and F reaches
+ *  every state once: 7! permutations of the other corners times 3^6
+ *  twists, 3,674,160 in all. The move tables come from the corner cubies
+ *  of the cube engine's face turns.
+ *
+ *  Enumerate visits every state by breadth first search with one bit per
+ *  state. Each level is split over threads that mark the next level with
+ *  atomic bit operations, so it doubles as an end to end benchmark of the
+ *  move tables and of how a search scales with cores.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef POCKETCUBE_HPP
+#define POCKETCUBE_HPP
+
+#include <cstdint>
+#include <vector>
+#include "CubieCube.hpp"
+
+class PocketCube{
+public:
+    static const int NUM_PERMS = 5040;      // 7! orders of the corners that move
+    static const int NUM_TWISTS = 729;      // 3^6, the seventh twist follows
+    static const int NUM_STATES = NUM_PERMS*NUM_TWISTS;
+    // U R F, each as quarter turn, half turn, inverse
+    static const int NUM_MOVES = 9;
+
+    // Constructor, builds the move tables
+    PocketCube();
+
+    // Index of the corners of a cube, which has to have DBL in place
+    static int Index(const CubieCube& cube);
+    // Index after one of the moves
+    int Move(int index, int move) const{
+        return m_permMove[index / NUM_TWISTS*NUM_MOVES + move]*NUM_TWISTS + m_twistMove[index % NUM_TWISTS*NUM_MOVES + move];
+    }
+
+    // Breadth first search from the solved cube over every state, with
+    // threads threads (0 means one per core). Returns the number of states
+    // at each distance.
+    std::vector<uint64_t> Enumerate(int threads = 0) const;
+
+private:
+    // coordinate after a move, indexed [coordinate*NUM_MOVES + move]
+    std::vector<uint16_t> m_permMove;
+    std::vector<uint16_t> m_twistMove;
+};
+
+#endif
@@ -0,0 +1,38 @@
+/** @file RandomState.hpp
+ *  @brief Uniformly random cubes, and scrambles that reach them.
+ *
+ *  Turning a cube at random for a while favours states close to the ones it
+ *  started from. Every state a real cube can reach is equally likely here:
+ *  the corner and edge permutations and the orientations are drawn as
+ *  coordinates, and the lowest bit of the edge permutation rank, which
+ *  swaps its last two edges, is flipped when the two parities disagree.
+ *
+ *  The numbers come from Philox, stream index of a seed for the index-th
+ *  state, so the same seed always gives the same states however many
+ *  threads split the indexes between them.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef RANDOMSTATE_HPP
+#define RANDOMSTATE_HPP
+
+#include <cstdint>
+#include <vector>
+#include "CubieCube.hpp"
+#include "Philox.hpp"
+#include "ThistlethwaiteSolver.hpp"
+
+class RandomState{
+public:
+    // The index-th random state of a seed
+    static CubieCube Generate(uint64_t seed, uint64_t index);
+    // A random state from the next numbers of a generator
+    static CubieCube Generate(Philox& random);
+
+    // Face turns that take the solved cube to cube, the inverse of a
+    // Thistlethwaite solution, about 32 moves
+    static std::vector<Move> Scramble(const CubieCube& cube, const ThistlethwaiteSolver& solver);
+};
+
+#endif
@@ -0,0 +1,119 @@
+/** @file RotationGroup.hpp
+ *  @brief The 24 rotations that map a cube onto itself.
+ *
+ *  Every orientation a sub cube can end up in after whole quarter turns
+ *  is one of these 24 rotations, so an orientation is a single index and
+ *  composing a turn onto it is one table lookup. Generated at compile time.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef ROTATIONGROUP_HPP
+#define ROTATIONGROUP_HPP
+
+namespace RotationGroup{
+    inline constexpr int NUM_ROTATIONS = 24;
+    // index of the identity rotation
+    inline constexpr int IDENTITY = 0;
+
+    // integer rotation matrix, m[row][col]
+    struct Matrix{
+        int m[3][3];
+    };
+
+    constexpr Matrix Multiply(const Matrix& a, const Matrix& b){
+        Matrix result{};
+        for (int r=0; r<3; r++){
+            for (int c=0; c<3; c++){
+                for (int k=0; k<3; k++){
+                    result.m[r][c] += a.m[r][k]*b.m[k][c];
+                }
+            }
+        }
+        return result;
+    }
+
+    constexpr bool Equal(const Matrix& a, const Matrix& b){
+        for (int r=0; r<3; r++){
+            for (int c=0; c<3; c++){
+                if (a.m[r][c] != b.m[r][c]) return false;
+            }
+        }
+        return true;
+    }
+
+    struct Tables{
+        Matrix rotations[NUM_ROTATIONS];
+        // compose[a][b] = rotation a applied after rotation b
+        int compose[NUM_ROTATIONS][NUM_ROTATIONS];
+        // quarterTurn[axis][k] = k counter-clockwise quarter turns around +axis
+        int quarterTurn[3][4];
+    };
+
+    constexpr int Find(const Tables& tables, const Matrix& matrix){
+        for (int i=0; i<NUM_ROTATIONS; i++){
+            if (Equal(tables.rotations[i], matrix)) return i;
+        }
+        return -1;
+    }
+
+    constexpr Tables BuildTables(){
+        Tables tables{};
+        // signed permutation matrices with determinant +1, identity first
+        const int perms[6][3] = {{0,1,2}, {1,2,0}, {2,0,1}, {0,2,1}, {2,1,0}, {1,0,2}};
+        int count = 0;
+        for (int p=0; p<6; p++){
+            for (int signs=0; signs<8; signs++){
+                Matrix matrix{};
+                int negatives = 0;
+                for (int r=0; r<3; r++){
+                    bool negative = (signs >> r) & 1;
+                    matrix.m[r][perms[p][r]] = negative ? -1 : 1;
+                    negatives += negative;
+                }
+                // odd permutations (p >= 3) need an odd number of negatives
+                if ((negatives % 2 == 1) == (p >= 3)){
+                    tables.rotations[count++] = matrix;
+                }
+            }
+        }
+        for (int a=0; a<NUM_ROTATIONS; a++){
+            for (int b=0; b<NUM_ROTATIONS; b++){
+                tables.compose[a][b] = Find(tables, Multiply(tables.rotations[a], tables.rotations[b]));
+            }
+        }
+        for (int axis=0; axis<3; axis++){
+            // one counter-clockwise quarter turn: a -> b, b -> -a
+            Matrix turn{};
+            int a = (axis+1) % 3;
+            int b = (axis+2) % 3;
+            turn.m[axis][axis] = 1;
+            turn.m[a][b] = -1;
+            turn.m[b][a] = 1;
+            int current = IDENTITY;
+            for (int k=0; k<4; k++){
+                tables.quarterTurn[axis][k] = current;
+                current = Find(tables, Multiply(turn, tables.rotations[current]));
+            }
+        }
+        return tables;
+    }
+
+    inline constexpr Tables TABLES = BuildTables();
+
+    // rotation a applied after rotation b
+    constexpr int Compose(int a, int b){
+        return TABLES.compose[a][b];
+    }
+
+    // counter-clockwise quarter turns around +axis (0 = x, 1 = y, 2 = z), any sign
+    constexpr int QuarterTurn(int axis, int turns){
+        return TABLES.quarterTurn[axis][((turns % 4) + 4) % 4];
+    }
+
+    constexpr const Matrix& GetMatrix(int rotation){
+        return TABLES.rotations[rotation];
+    }
+}
+
+#endif
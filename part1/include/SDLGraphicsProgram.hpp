@@ -17,10 +17,17 @@
 
 // The glad library helps setup OpenGL extensions.
 #include <glad/glad.h>
+#include <chrono>
+#include <string>
 #include <vector>
-#include <map>
 #include "glm/gtx/transform.hpp"
-#include "Transform.hpp"
+#include "CubeSimulation.hpp"
+#include "AnimationClock.hpp"
+#include "TwoPhaseSolver.hpp"
+#include "AnytimeSolver.hpp"
+#include "CfopSolver.hpp"
+#include "SolutionCache.hpp"
+#include "ThistlethwaiteSolver.hpp"
 
 // Purpose:
 // This class sets up a full graphics program using SDL
@@ -59,16 +66,32 @@ public:
     SDL_Window* GetSDLWindow();
     // Helper Function to Query OpenGL information.
     void GetOpenGLVersionInfo();
+    // Parse a move script (standard notation) to play back on the cube
+    bool LoadScript(const std::string& path);
 
 private:
-    // load all cubes in order, populate subCubePositions
+    // load all cubes in order
     void LoadCubes();
-    // when rotation is finished, update subCubePositions to reflect changes
-    void UpdateSubCubePositions();
-    // update the rotation state if is NONE
-    void UpdateRotationState(Rotation rotation);
-    // get post-rotated indices
-    std::map<int,int> GetUpdatedIndices(std::vector<int> face);
+    // queue a rotation, it starts as soon as the moves before it finish
+    void QueueRotation(Rotation rotation);
+    // cube engine move for a rotation in the current rotation direction
+    Move GetMove(Rotation rotation) const;
+    // move pending moves into the queue as space frees up
+    void FeedPendingMoves();
+    // the cube as it will be once every waiting move is done
+    CubeState GetPendingState() const;
+    // solve the pending state, the solution is queued behind the waiting
+    // moves straight away if it is cached, otherwise by PollSolver
+    void SolveCube();
+    // once per frame, never waits: queue the background solution when its
+    // budget is up, and cache shorter ones found after that
+    void PollSolver();
+    // queue a solution and report it with the cache statistics
+    void QueueSolution(const std::vector<Move>& solution, double milliseconds, bool cached);
+    // queue moves that take the pending state to the next uniformly random state
+    void ScrambleCube();
+    // queue a layer by layer solution of the pending state and report its stages
+    void SolveLayerByLayer();
 
     // Screen dimension constants
     int m_screenWidth;
@@ -79,90 +102,45 @@ private:
     SDL_GLContext m_openGLContext;
 
     // ====== sub cube vars ======
-    // number of sub cubes = (9*3)
-    // Note: rendering the middle cube makes math easier even if it's not used
-    static int const NUM_SUB_CUBES = 27;
-    // mapping of rotation type to rotation axis
-    const std::map<Rotation, Transform::RotationType> rotationAxes = {
-        // None: no rotation axis
-        {Rotation::NONE,       Transform::RotationType::NONE},
-        // slices going back on z axis
-        {Rotation::FRONT_Z,    Transform::RotationType::ROLL},
-        {Rotation::MID_Z,      Transform::RotationType::ROLL},
-        {Rotation::BACK_Z,     Transform::RotationType::ROLL},
-        // slices going down on y axis
-        {Rotation::TOP_Y,      Transform::RotationType::PITCH},
-        {Rotation::MID_Y,      Transform::RotationType::PITCH},
-        {Rotation::BOTTOM_Y,   Transform::RotationType::PITCH},
-        // slices going across on x axis
-        {Rotation::LEFT_X,     Transform::RotationType::YAW},
-        {Rotation::MID_X,      Transform::RotationType::YAW},
-        {Rotation::RIGHT_X,    Transform::RotationType::YAW}
-    };
-
-    // map from rotation type to absolute indices of affected sub cubes
-    const std::map<Rotation, std::vector<int>> rotationMap ={
-        {Rotation::NONE,       std::vector<int>{}},
-        // slices going back on z axis
-        {Rotation::FRONT_Z,    std::vector<int>{0,1,2, 3,4,5, 6,7,8}},
-        {Rotation::MID_Z,      std::vector<int>{9,10,11, 12,13,14, 15,16,17}},
-        {Rotation::BACK_Z,     std::vector<int>{18,19,20, 21,22,23, 24,25,26}},
-        // slices going down on y axis
-        {Rotation::TOP_Y,      std::vector<int>{18,19,20, 9,10,11, 0,1,2}},
-        {Rotation::MID_Y,      std::vector<int>{21,22,23, 12,13,14, 3,4,5}},
-        {Rotation::BOTTOM_Y,   std::vector<int>{24,25,26, 15,16,17, 6,7,8}},
-        // slices going across on x axis
-        {Rotation::LEFT_X,     std::vector<int>{6,3,0, 15,12,9, 24,21,18}},
-        {Rotation::MID_X,      std::vector<int>{7,4,1, 16,13,10, 25,22,19}},
-        {Rotation::RIGHT_X,    std::vector<int>{8,5,2, 17,14,11, 26,23,20}}
-    };
-
-    // map absolute cube indices to positions to transform in space
-    const std::map<int, glm::vec3> idxToPositionMap = {
-        {0, glm::vec3(-1.0f,1.0f,1.0f)},
-        {1, glm::vec3(0.0f,1.0f,1.0f)},
-        {2, glm::vec3(1.0f,1.0f,1.0f)},
-        {3, glm::vec3(-1.0f,0.0f,1.0f)},
-        {4, glm::vec3(0.0f,0.0f,1.0f)},
-        {5, glm::vec3(1.0f,0.0f,1.0f)},
-        {6, glm::vec3(-1.0f,-1.0f,1.0f)},
-        {7, glm::vec3(0.0f,-1.0f,1.0f)},
-        {8, glm::vec3(1.0f,-1.0f,1.0f)},
-        {9, glm::vec3(-1.0f,1.0f,0.0f)},
-        {10, glm::vec3(0.0f,1.0f,0.0f)},
-        {11, glm::vec3(1.0f,1.0f,0.0f)},
-        {12, glm::vec3(-1.0f,0.0f,0.0f)},
-        {13, glm::vec3(0.0f,0.0f,0.0f)},
-        {14, glm::vec3(1.0f,0.0f,0.0f)},
-        {15, glm::vec3(-1.0f,-1.0f,0.0f)},
-        {16, glm::vec3(0.0f,-1.0f,0.0f)},
-        {17, glm::vec3(1.0f,-1.0f,0.0f)},
-        {18, glm::vec3(-1.0f,1.0f,-1.0f)},
-        {19, glm::vec3(0.0f,1.0f,-1.0f)},
-        {20, glm::vec3(1.0f,1.0f,-1.0f)},
-        {21, glm::vec3(-1.0f,0.0f,-1.0f)},
-        {22, glm::vec3(0.0f,0.0f,-1.0f)},
-        {23, glm::vec3(1.0f,0.0f,-1.0f)},
-        {24, glm::vec3(-1.0f,-1.0f,-1.0f)},
-        {25, glm::vec3(0.0f,-1.0f,-1.0f)},
-        {26, glm::vec3(1.0f,-1.0f,-1.0f)}
-    };
-
-    // map type of rotation to absolute rotation axis
-    const std::map<Transform::RotationType, glm::vec3> rotationTypeMap = {
-        {Transform::RotationType::NONE,     glm::vec3(0.0f,0.0f,0.0f)},
-        {Transform::RotationType::ROLL,     glm::vec3(0.0f,0.0f,1.0f)},
-        {Transform::RotationType::PITCH,    glm::vec3(0.0f,1.0f,0.0f)},
-        {Transform::RotationType::YAW,      glm::vec3(1.0f,0.0f,0.0f)}
-    };
-
-    // index pointers to absolute subcube positions (e.g. the front facing top left subcube = 0)
-    // the index is the absolute position, the value is the sub cube position in the object manager
-    std::vector<int> subCubePositions;
-    // state of rotation updated by keypresses - None if static
-    Rotation rotationState;
+    // cube logic and animation, the sub cube objects just draw its transforms
+    CubeSimulation simulation;
+    // simulation runs in fixed 1/120 second steps
+    AnimationClock animationClock{1.0/120.0};
     // clockwise=-1 or counter-clockwise=1
     int rotationDirection = -1;
+    // moves from a script or the solver that have not been queued yet
+    std::vector<Move> pendingMoves;
+    size_t pendingPosition = 0;
+    // the best solution after SOLVE_BUDGET_MILLISECONDS is the one played,
+    // the search goes on for up to SOLVE_IMPROVE_SECONDS or until it finds
+    // SOLVE_TARGET_LENGTH face turns, and shorter solutions are cached
+    static constexpr int SOLVE_BUDGET_MILLISECONDS = 100;
+    static constexpr int SOLVE_TARGET_LENGTH = 18;
+    static constexpr double SOLVE_IMPROVE_SECONDS = 5.0;
+    // solver tables are built once at startup so solving never stalls a frame for long
+    TwoPhaseSolver solver;
+    // solves on its own thread, Loop only ever polls it
+    AnytimeSolver anytimeSolver{solver};
+    // a solve whose budget is not up yet, when it started, and the version
+    // of the background solution last used (0 once there is nothing to poll)
+    bool solveWaiting = false;
+    std::chrono::steady_clock::time_point solveStart;
+    int solveVersion = 0;
+    // states solved before (or symmetric to one) are answered from here,
+    // kept across runs in SOLUTION_CACHE_FILE
+    static constexpr const char* SOLUTION_CACHE_FILE = "solutions.cache";
+    static constexpr size_t SOLUTION_CACHE_BYTES = 16*1024*1024;
+    SolutionCache solutionCache{SOLUTION_CACHE_BYTES};
+    // random states are the randomIndex-th ones of randomSeed, which is
+    // printed so a session's scrambles can be made again
+    ThistlethwaiteSolver scrambler;
+    uint64_t randomSeed = 0;
+    uint64_t randomIndex = 0;
+    // layer by layer solutions, with the tables ./llgen writes to
+    // CFOP_TABLE_DIRECTORY. They are only mapped, never generated here, so
+    // the window opens at once; without them l is off.
+    static constexpr const char* CFOP_TABLE_DIRECTORY = "tables";
+    CfopSolver cfopSolver{CFOP_TABLE_DIRECTORY, 0, false};
 };
 
 #endif
@@ -0,0 +1,120 @@
+/** @file SolutionCache.hpp
+ *  @brief Solutions of states solved before, shared by symmetric states.
+ *
+ *  Entries are keyed by Symmetry::CanonicalHash, and hold a solution of
+ *  the canonical representative, so a state also hits on the solution of
+ *  any state symmetric or antisymmetric to it. The solution is mapped
+ *  back by conjugating (and for the inverse, reversing) its moves.
+ *
+ *  The cache is a fixed array of entries, sized by a memory cap and
+ *  split into sets of WAYS entries by key. A full set evicts with the
+ *  CLOCK rule: the hand skips (and clears) entries used since it last
+ *  passed, and takes the first one that was not. The array can live in a
+ *  file, mapped at startup, so solutions survive restarts.
+ *
+ *  Not thread safe, the interactive program solves on one thread.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef SOLUTIONCACHE_HPP
+#define SOLUTIONCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CubeState.hpp"
+
+class SolutionCache{
+public:
+    // longest solution an entry holds, in face turns
+    static const int MAX_SOLUTION_LENGTH = 38;
+    // entries per set
+    static const int WAYS = 8;
+    static const size_t DEFAULT_BYTES = 16*1024*1024;
+    // bumped whenever the file layout changes
+    static const uint32_t FILE_VERSION = 1;
+
+    // What the cache did so far
+    struct Counters{
+        long long lookups = 0;
+        long long hits = 0;
+        long long inserts = 0;
+        long long evictions = 0;
+        // time spent in Lookup, hits and misses
+        double lookupSeconds = 0.0;
+        double HitRate() const;
+        double AverageLookupMicroseconds() const;
+    };
+
+    // Constructor, empty cache of at most maxBytes held in memory
+    SolutionCache(size_t maxBytes = DEFAULT_BYTES);
+    // Destructor, writes back and unmaps the file if there is one
+    ~SolutionCache();
+    // The cache may own a file mapping, so it is never copied
+    SolutionCache(const SolutionCache&) = delete;
+    SolutionCache& operator=(const SolutionCache&) = delete;
+
+    // Keep the entries in a file from now on. A file written with the
+    // same layout and size is mapped with its entries, anything else is
+    // replaced by an empty cache. Returns false and prints why if the
+    // file can not be used, the cache then stays in memory.
+    bool OpenFile(const std::string& path);
+
+    // Solution for a state if it, or a state symmetric to it, is cached.
+    // Whole cube rotations come first if the centers are not home.
+    bool Lookup(const CubeState& state, std::vector<Move>& solution);
+    // Remember the solution of a state. Solutions that do not solve the
+    // state, or are longer than MAX_SOLUTION_LENGTH, are not stored.
+    void Insert(const CubeState& state, const std::vector<Move>& solution);
+    // Drop every entry, the counters stay
+    void Clear();
+
+    // Entries in use, and entries there is room for
+    size_t Size() const;
+    size_t Capacity() const;
+    const Counters& GetCounters() const;
+
+private:
+    // one cached solution, 48 bytes
+    struct Entry{
+        // canonical hash, 0 marks a free entry
+        uint64_t key;
+        uint8_t length;
+        // set on every hit, cleared as the clock hand passes
+        uint8_t referenced;
+        // face turns 0..17 solving the canonical representative
+        uint8_t moves[MAX_SOLUTION_LENGTH];
+    };
+    // start of a file, the entries follow
+    struct FileHeader{
+        char magic[8];
+        uint32_t version;
+        uint32_t entrySize;
+        uint64_t entries;
+    };
+
+    void Allocate(size_t entries);
+    void Unmap();
+    Entry* Find(uint64_t key);
+
+    // entries of an in memory cache
+    std::vector<Entry> m_memory;
+    // the entries in use, m_memory or part of the file mapping
+    Entry* m_entries;
+    size_t m_numEntries;
+    size_t m_size;
+    // clock hand of every set
+    std::vector<uint8_t> m_hands;
+
+    // the whole mapped file, nullptr if there is none
+    void* m_mapping;
+    size_t m_mappingBytes;
+    // file written back by the destructor where nothing can be mapped
+    std::string m_writeBackPath;
+
+    Counters m_counters;
+};
+
+#endif
@@ -0,0 +1,68 @@
+/** @file Symmetry.hpp
+ *  @brief The 48 symmetries of the cube and symmetry reduced lookups.
+ *
+ *  A symmetry is a whole cube rotation, possibly followed by a left-right
+ *  mirror, written as a CubieCube (mirrored corners have orientation 3..5).
+ *  Conjugating a state by a symmetry, S * C * S^-1, relabels it without
+ *  changing how far it is from solved, and neither does inverting it. So
+ *  tables keyed by distance only need one entry for all up to 96 states
+ *  that are symmetric or antisymmetric to each other: the canonical
+ *  representative.
+ *
+ *  Symmetries 0..15 keep the U-D axis in place. Under those the twist of
+ *  a conjugate only depends on the twist, which makes symmetry reduced
+ *  corner coordinates possible, see CornerClass.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef SYMMETRY_HPP
+#define SYMMETRY_HPP
+
+#include <cstdint>
+#include "CubieCube.hpp"
+
+class Symmetry{
+public:
+    // rotations and mirrored rotations
+    static const int NUM_SYMMETRIES = 48;
+    // the ones that map U and D onto U and D
+    static const int NUM_UD_SYMMETRIES = 16;
+    // corner permutations, 8!, fall into this many classes under those 16
+    static const int NUM_CORNER_CLASSES = 2768;
+
+    // Cubies of a symmetry, 0 is the identity
+    static const CubieCube& Cube(int symmetry);
+    // Symmetry that undoes another
+    static int Inverse(int symmetry);
+    // Face turn (0..17) that is S * move * S^-1
+    static int ConjugateMove(int move, int symmetry);
+
+    // S * cube * S^-1 for the symmetry S
+    static CubieCube Conjugate(const CubieCube& cube, int symmetry);
+    // The smallest conjugate of the cube or its inverse. symmetry and
+    // inverted, if given, say which: the representative is
+    // S * cube * S^-1 or S * cube^-1 * S^-1. Solutions of the two differ
+    // by that relabeling, and are reversed and inverted for the inverse.
+    static CubieCube Canonical(const CubieCube& cube, int* symmetry = nullptr, bool* inverted = nullptr);
+    // 64 bit key of the canonical representative, equal for every
+    // symmetric or antisymmetric state, to key caches and transposition
+    // tables. symmetry and inverted are the same as for Canonical.
+    static uint64_t CanonicalHash(const CubieCube& cube, int* symmetry = nullptr, bool* inverted = nullptr);
+
+    // * coordinates reduced by the 16 U-D symmetries
+    // Class of a corner permutation (0..8!-1), and a symmetry that
+    // conjugates the permutation to the representative of its class
+    static int CornerClass(int cornerPerm);
+    static int CornerClassSymmetry(int cornerPerm);
+    // Corner permutation that represents a class
+    static int CornerRepresentative(int cornerClass);
+    // Bit s is set for every symmetry s below 16 that leaves the
+    // representative of a class as it is. Twists conjugated by those give
+    // symmetric states, which tables have to give the same entry.
+    static int CornerClassStabilizer(int cornerClass);
+    // Twist of S * cube * S^-1 from the twist of cube, symmetry below 16
+    static int ConjugateTwist(int twist, int symmetry);
+};
+
+#endif
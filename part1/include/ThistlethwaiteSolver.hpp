@@ -0,0 +1,49 @@
+/** @file ThistlethwaiteSolver.hpp
+ *  @brief Thistlethwaite's four-phase algorithm, some solution in microseconds.
+ *
+ *  Each phase moves the cube into a smaller group using only the moves of
+ *  the group it is in:
+ *    G0 = <U, D, R, L, F, B>           fix edge orientation
+ *    G1 = <U, D, R, L, F2, B2>         fix corner orientation, middle layer edges
+ *    G2 = <U, D, R2, L2, F2, B2>       corners into their diagonal pairs, M slice edges, parity
+ *    G3 = <U2, D2, R2, L2, F2, B2>     solve
+ *  Every phase has a table with the distance of each of its coordinates
+ *  from the goal, mod 3 at two bits an entry, and move tables that step a
+ *  coordinate without touching cubies, about 730 kilobytes for all four
+ *  phases. Solving never searches: it takes any move to a coordinate one
+ *  closer until the phase is done. Solutions average 32 moves, longer than
+ *  the two-phase solver's, but take about 5 microseconds.
+ *
+ *  The tables are built by breadth first search the first time a solver is
+ *  made (a fraction of a second) and shared by every solver after that.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef THISTLETHWAITESOLVER_HPP
+#define THISTLETHWAITESOLVER_HPP
+
+#include <cstddef>
+#include <vector>
+#include "CubeState.hpp"
+
+class ThistlethwaiteSolver{
+public:
+    static const int NUM_PHASES = 4;
+    // no phase needs more moves than 7, 10, 13 and 15
+    static const int MAX_LENGTH = 45;
+
+    // Constructor, builds the shared tables if no solver did yet
+    ThistlethwaiteSolver();
+
+    // Find a solution for state, written to solution. Whole cube rotations
+    // come first if the centers are not home, the rest are face turns.
+    // Center spin is ignored. Returns false only for states that can not be
+    // solved. Safe to call from several threads at once.
+    bool Solve(const CubeState& state, std::vector<Move>& solution) const;
+
+    // Bytes of memory the tables take
+    static size_t MemoryFootprint();
+};
+
+#endif
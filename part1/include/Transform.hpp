@@ -9,9 +9,6 @@
 #ifndef TRANSFORM_HPP
 #define TRANSFORM_HPP
 
-#include <map>
-#include <utility>
-#include <vector>
 #include <glad/glad.h>
 #include "glm/vec3.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -63,14 +60,16 @@ public:
     // Addition
     friend Transform operator+(const Transform& lhs, const Transform& rhs);
     // When a cube finishes rotating, keep track of its post-rotated state
+    // (radians are snapped to whole quarter turns)
     void UpdateIdentityRotation(RotationType rotationType, float radians);
     // Apply post-rotated state of sub cube (roll,pitch,yaw)
     void ApplyIdentityRotation();
 private:
     // Stores the actual transformation matrix
     glm::mat4 m_modelTransformMatrix;
-    // rotate identity per-axis
-    std::vector<std::pair<RotationType, float>> appliedRotations;
+    // post-rotated state as an index into the 24 cube rotations,
+    // composed once per finished turn so applying it is O(1)
+    int identityRotation;
 };
 
 
@@ -0,0 +1,119 @@
+/** @file TranspositionTable.hpp
+ *  @brief Open addressing hash table keyed by 64 bit state hashes.
+ *
+ *  Keys are already well mixed Zobrist hashes, so the slot is just the
+ *  low bits of the key and collisions probe linearly. Entries live in one
+ *  flat array, the table doubles when it gets 3/4 full. Two states with
+ *  the same 64 bit hash share an entry.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef TRANSPOSITIONTABLE_HPP
+#define TRANSPOSITIONTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+template<typename Value>
+class TranspositionTable{
+public:
+    // Constructor, capacity is rounded up to a power of two
+    TranspositionTable(size_t capacity = 1024){
+        size_t rounded = MIN_CAPACITY;
+        while (rounded < capacity){
+            rounded *= 2;
+        }
+        m_entries.resize(rounded);
+        m_size = 0;
+    }
+
+    // Pointer to the value stored for a key, nullptr if there is none
+    Value* Find(uint64_t key){
+        Entry& entry = Probe(StoredKey(key));
+        return entry.key != EMPTY ? &entry.value : nullptr;
+    }
+    const Value* Find(uint64_t key) const{
+        return const_cast<TranspositionTable*>(this)->Find(key);
+    }
+
+    bool Contains(uint64_t key) const{
+        return Find(key) != nullptr;
+    }
+
+    // Value for a key, inserted as Value() if it is not there yet
+    Value& operator[](uint64_t key){
+        if ((m_size + 1)*4 > m_entries.size()*3){
+            Grow();
+        }
+        Entry& entry = Probe(StoredKey(key));
+        if (entry.key == EMPTY){
+            entry.key = StoredKey(key);
+            entry.value = Value();
+            m_size++;
+        }
+        return entry.value;
+    }
+
+    // Store a value, replacing the one already stored for the key
+    void Store(uint64_t key, const Value& value){
+        (*this)[key] = value;
+    }
+
+    // Drop every entry, the capacity stays
+    void Clear(){
+        for (Entry& entry : m_entries){
+            entry.key = EMPTY;
+        }
+        m_size = 0;
+    }
+
+    size_t Size() const{
+        return m_size;
+    }
+
+    size_t Capacity() const{
+        return m_entries.size();
+    }
+
+private:
+    static const size_t MIN_CAPACITY = 16;
+    // key 0 marks a free slot, a real key of 0 is stored as 1 instead
+    static const uint64_t EMPTY = 0;
+
+    struct Entry{
+        uint64_t key = EMPTY;
+        Value value = Value();
+    };
+
+    static uint64_t StoredKey(uint64_t key){
+        return key != EMPTY ? key : 1;
+    }
+
+    // slot holding the key, or the free slot where it would go
+    Entry& Probe(uint64_t key){
+        size_t mask = m_entries.size() - 1;
+        size_t slot = key & mask;
+        while (m_entries[slot].key != EMPTY && m_entries[slot].key != key){
+            slot = (slot + 1) & mask;
+        }
+        return m_entries[slot];
+    }
+
+    // double the capacity and reinsert every entry
+    void Grow(){
+        std::vector<Entry> old(m_entries.size()*2);
+        old.swap(m_entries);
+        for (const Entry& entry : old){
+            if (entry.key != EMPTY){
+                Probe(entry.key) = entry;
+            }
+        }
+    }
+
+    std::vector<Entry> m_entries;
+    size_t m_size;
+};
+
+#endif
@@ -0,0 +1,87 @@
+/** @file TwoPhaseSolver.hpp
+ *  @brief Kociemba's two-phase algorithm for solving the cube.
+ *
+ *  Phase 1 brings the cube into the subgroup <U, D, R2, L2, F2, B2>
+ *  (every piece oriented, middle layer edges in the middle layer), phase 2
+ *  solves it with those moves only. Both phases are IDA* searches over
+ *  coordinates, small integers describing part of the state, with move
+ *  tables for the coordinates and pruning tables for the heuristic. The
+ *  search keeps going after the first solution until one is short enough
+ *  or time is up, and can hand out every shorter solution as it finds
+ *  them, so a caller always has the best one so far.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef TWOPHASESOLVER_HPP
+#define TWOPHASESOLVER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "CubeState.hpp"
+
+class TwoPhaseSolver{
+public:
+    // sizes of the coordinates
+    static const int NUM_TWISTS = 2187;         // 3^7 corner orientations
+    static const int NUM_FLIPS = 2048;          // 2^11 edge orientations
+    static const int NUM_SLICES = 495;          // 12 choose 4 middle layer edge positions
+    static const int NUM_CORNER_PERMS = 40320;  // 8!
+    static const int NUM_UD_EDGE_PERMS = 40320; // 8! for the U and D layer edges in phase 2
+    static const int NUM_SLICE_PERMS = 24;      // 4! for the middle layer edges in phase 2
+    // moves allowed in phase 2: U, D and half turns of the other faces
+    static const int NUM_PHASE2_MOVES = 10;
+    // longest solution the search will ever need
+    static const int MAX_LENGTH = 31;
+    // gets each solution that is shorter than every one found before it,
+    // called on the thread running Solve
+    typedef std::function<void(const std::vector<Move>&)> Progress;
+
+    // Constructor, builds every move and pruning table (takes a moment)
+    TwoPhaseSolver();
+
+    // Find a solution for state, written to solution. Whole cube rotations
+    // come first if the centers are not home, the rest are face turns.
+    // Stops at the first solution of at most targetLength moves, or at the
+    // best one found once maxSeconds have passed. Center spin is ignored,
+    // like on a real cube. Returns false only for states that can not be
+    // solved, or when stopped before the first solution. nodes, if given,
+    // gets the number of nodes both phases searched. progress, if given,
+    // sees every improvement as it is found, and setting stop ends the
+    // search early with the best solution so far. Safe to call from
+    // several threads at once.
+    bool Solve(const CubeState& state, std::vector<Move>& solution,
+               int targetLength = 20, double maxSeconds = 0.1, long long* nodes = nullptr,
+               const Progress& progress = Progress(), const std::atomic<bool>* stop = nullptr) const;
+
+    // Bytes of memory the move and pruning tables take
+    size_t MemoryFootprint() const;
+
+private:
+    // search state of one Solve call
+    struct Search;
+
+    bool Phase1(Search& search, int twist, int flip, int slice, int depth, int togo) const;
+    void StartPhase2(Search& search, int length1) const;
+    bool Phase2(Search& search, int cornerPerm, int udEdgePerm, int slicePerm, int depth, int togo) const;
+
+    // coordinate after a move, indexed [coordinate*NUM_FACE_MOVES + move]
+    std::vector<uint16_t> m_twistMove;
+    std::vector<uint16_t> m_flipMove;
+    std::vector<uint16_t> m_sliceMove;
+    std::vector<uint16_t> m_cornerPermMove;
+    // phase 2 only coordinates, indexed [coordinate*NUM_PHASE2_MOVES + phase 2 move]
+    std::vector<uint16_t> m_udEdgePermMove;
+    std::vector<uint16_t> m_slicePermMove;
+
+    // fewest moves to reach the goal of a phase, pairs of coordinates
+    std::vector<int8_t> m_twistSlicePrune;
+    std::vector<int8_t> m_flipSlicePrune;
+    std::vector<int8_t> m_cornerSlicePermPrune;
+    std::vector<int8_t> m_edgeSlicePermPrune;
+};
+
+#endif
@@ -0,0 +1,72 @@
+/** @file ZobristHash.hpp
+ *  @brief 64 bit hash of a cube state that is updated move by move.
+ *
+ *  The hash XORs one random key for every (byte position, byte value)
+ *  pair of the packed state. A move only changes the bytes of the pieces
+ *  it turns, so the hash is updated by XORing out their old keys and in
+ *  their new ones instead of hashing all 32 bytes again. Keys and the
+ *  list of bytes each move changes are generated at compile time.
+ *
+ *  @author John C.
+ *  @bug No known bugs.
+ */
+#ifndef ZOBRISTHASH_HPP
+#define ZOBRISTHASH_HPP
+
+#include <cstdint>
+#include "CubeState.hpp"
+#include "MoveTables.hpp"
+
+namespace ZobristHash{
+    // packed bytes never reach 32 (piece and orientation in 5 bits)
+    inline constexpr int NUM_BYTE_VALUES = 32;
+
+    // bytes of the packed state that a move changes
+    struct ChangedBytes{
+        uint8_t count;
+        uint8_t positions[CubeState::PACKED_SIZE];
+    };
+
+    struct Tables{
+        uint64_t keys[CubeState::PACKED_SIZE][NUM_BYTE_VALUES];
+        ChangedBytes changed[CubeState::NUM_MOVES];
+    };
+
+    // splitmix64, fixed seed so hashes are the same on every run and machine
+    constexpr uint64_t NextKey(uint64_t& seed){
+        seed += 0x9E3779B97F4A7C15ull;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    constexpr Tables BuildTables(){
+        Tables tables{};
+        uint64_t seed = 0x5EED0C0BE5EEDull;
+        for (int i=0; i<CubeState::PACKED_SIZE; i++){
+            for (int v=0; v<NUM_BYTE_VALUES; v++){
+                tables.keys[i][v] = NextKey(seed);
+            }
+        }
+        for (int m=0; m<CubeState::NUM_MOVES; m++){
+            const MoveTables::MoveTable& move = MoveTables::TABLES.moves[m];
+            for (int i=0; i<CubeState::PACKED_SIZE; i++){
+                if (move.perm[i] != i || move.add[i] != 0){
+                    tables.changed[m].positions[tables.changed[m].count++] = i;
+                }
+            }
+        }
+        return tables;
+    }
+
+    inline constexpr Tables TABLES = BuildTables();
+
+    // Hash of a whole state
+    uint64_t Compute(const CubeState& state);
+    // Apply a move to a state and return its updated hash, hash must be the
+    // state's hash before the move
+    uint64_t ApplyMove(CubeState& state, uint64_t hash, Move move);
+}
+
+#endif
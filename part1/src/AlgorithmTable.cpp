@@ -0,0 +1,228 @@
+#include "AlgorithmTable.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AlgorithmTable::AlgorithmTable(int cases, const char* magic){
+    m_cases = cases;
+    std::memset(m_magic, 0, sizeof(m_magic));
+    std::strncpy(m_magic, magic, sizeof(m_magic) - 1);
+    m_entries = nullptr;
+    m_moves = nullptr;
+    m_moveBytes = 0;
+    m_mapping = nullptr;
+    m_mappingBytes = 0;
+}
+
+AlgorithmTable::~AlgorithmTable(){
+    Unmap();
+}
+
+void AlgorithmTable::Reset(const std::vector<std::vector<Move>>& algorithms){
+    Unmap();
+    std::vector<uint8_t> moves;
+    m_memory.assign(m_cases, 0);
+    for (int number=0; number<m_cases; number++){
+        const std::vector<Move>* algorithm = size_t(number) < algorithms.size() ? &algorithms[number] : nullptr;
+        if (algorithm == nullptr || (algorithm->empty() && number != 0) || algorithm->size() > size_t(MAX_LENGTH)){
+            m_memory[number] = NO_ALGORITHM;
+            continue;
+        }
+        m_memory[number] = uint32_t(moves.size()) << 8 | uint32_t(algorithm->size());
+        for (Move move : *algorithm){
+            moves.push_back(static_cast<uint8_t>(move));
+        }
+    }
+    m_moveBytes = moves.size();
+    m_memory.resize(m_cases + (moves.size() + 3)/4, 0);
+    std::memcpy(m_memory.data() + m_cases, moves.data(), moves.size());
+    m_entries = m_memory.data();
+    m_moves = reinterpret_cast<const uint8_t*>(m_memory.data() + m_cases);
+}
+
+bool AlgorithmTable::Lookup(int number, std::vector<Move>& moves) const{
+    if (m_entries == nullptr || number < 0 || number >= m_cases){
+        return false;
+    }
+    uint32_t entry = m_entries[number];
+    uint32_t length = entry & 0xFF;
+    if (length == NO_ALGORITHM){
+        return false;
+    }
+    const uint8_t* algorithm = m_moves + (entry >> 8);
+    for (uint32_t i=0; i<length; i++){
+        moves.push_back(static_cast<Move>(algorithm[i]));
+    }
+    return true;
+}
+
+int AlgorithmTable::Length(int number) const{
+    if (m_entries == nullptr || number < 0 || number >= m_cases){
+        return -1;
+    }
+    uint32_t length = m_entries[number] & 0xFF;
+    return length == NO_ALGORITHM ? -1 : int(length);
+}
+
+int AlgorithmTable::NumCases() const{
+    return m_cases;
+}
+
+int AlgorithmTable::Cases() const{
+    int cases = 0;
+    for (int number=0; number<m_cases; number++){
+        cases += Length(number) >= 0;
+    }
+    return cases;
+}
+
+size_t AlgorithmTable::Bytes() const{
+    return m_entries == nullptr ? 0 : m_cases*sizeof(uint32_t) + m_moveBytes;
+}
+
+bool AlgorithmTable::IsMapped() const{
+    return m_mapping != nullptr;
+}
+
+AlgorithmTable::FileHeader AlgorithmTable::MakeHeader(uint64_t moveBytes) const{
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, m_magic, sizeof(header.magic));
+    header.version = FILE_VERSION;
+    header.cases = m_cases;
+    header.moveBytes = moveBytes;
+    header.dataOffset = FILE_DATA_OFFSET;
+    return header;
+}
+
+bool AlgorithmTable::Save(const std::string& path) const{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file || m_entries == nullptr){
+        std::cout << "Could not write algorithm table " << path << std::endl;
+        return false;
+    }
+    std::vector<char> page(FILE_DATA_OFFSET, 0);
+    FileHeader header = MakeHeader(m_moveBytes);
+    std::memcpy(page.data(), &header, sizeof(header));
+    file.write(page.data(), page.size());
+    file.write(reinterpret_cast<const char*>(m_entries), m_cases*sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(m_moves), m_moveBytes);
+    if (!file){
+        std::cout << "Could not write algorithm table " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool AlgorithmTable::Load(const std::string& path){
+    FileHeader header;
+    uint64_t fileBytes = 0;
+#if defined(_WIN32)
+    // no mmap here, read the whole table instead
+    std::ifstream file(path, std::ios::binary);
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header))){
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    fileBytes = file.tellg();
+#else
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0){
+        return false;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || uint64_t(status.st_size) < sizeof(header)){
+        close(descriptor);
+        std::cout << "Algorithm table " << path << " is too short" << std::endl;
+        return false;
+    }
+    fileBytes = status.st_size;
+    void* mapping = mmap(nullptr, fileBytes, PROT_READ, MAP_SHARED, descriptor, 0);
+    // the mapping stays valid once the file is closed
+    close(descriptor);
+    if (mapping == MAP_FAILED){
+        std::cout << "Could not map algorithm table " << path << std::endl;
+        return false;
+    }
+    std::memcpy(&header, mapping, sizeof(header));
+#endif
+
+    FileHeader expected = MakeHeader(header.moveBytes);
+    uint64_t dataBytes = m_cases*sizeof(uint32_t) + header.moveBytes;
+    if (std::memcmp(&header, &expected, sizeof(header)) != 0 || header.moveBytes > fileBytes
+        || fileBytes < FILE_DATA_OFFSET + dataBytes){
+        std::cout << "Algorithm table " << path << " is not a " << m_magic << " table of version " << FILE_VERSION
+                  << " with " << m_cases << " cases, generate it again" << std::endl;
+#if !defined(_WIN32)
+        munmap(mapping, fileBytes);
+#endif
+        return false;
+    }
+
+    Unmap();
+    m_moveBytes = header.moveBytes;
+#if defined(_WIN32)
+    m_memory.resize(m_cases + (m_moveBytes + 3)/4);
+    file.seekg(FILE_DATA_OFFSET);
+    if (!file.read(reinterpret_cast<char*>(m_memory.data()), dataBytes)){
+        std::cout << "Could not read algorithm table " << path << std::endl;
+        m_memory.clear();
+        m_moveBytes = 0;
+        return false;
+    }
+    m_entries = m_memory.data();
+    m_moves = reinterpret_cast<const uint8_t*>(m_memory.data() + m_cases);
+#else
+    m_memory.clear();
+    m_memory.shrink_to_fit();
+    m_mapping = mapping;
+    m_mappingBytes = fileBytes;
+    m_entries = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(mapping) + FILE_DATA_OFFSET);
+    m_moves = reinterpret_cast<const uint8_t*>(m_entries + m_cases);
+#endif
+    // the rest is trusted from here on, so a damaged file has to fail now
+    if (!IsConsistent()){
+        std::cout << "Algorithm table " << path << " is damaged, generate it again" << std::endl;
+        Unmap();
+        m_memory.clear();
+        m_moveBytes = 0;
+        return false;
+    }
+    return true;
+}
+
+bool AlgorithmTable::IsConsistent() const{
+    for (int number=0; number<m_cases; number++){
+        uint32_t entry = m_entries[number];
+        uint32_t length = entry & 0xFF;
+        if (length != NO_ALGORITHM && uint64_t(entry >> 8) + length > m_moveBytes){
+            return false;
+        }
+    }
+    for (uint64_t i=0; i<m_moveBytes; i++){
+        if (m_moves[i] >= CubeState::NUM_FACE_MOVES){
+            return false;
+        }
+    }
+    return true;
+}
+
+void AlgorithmTable::Unmap(){
+#if !defined(_WIN32)
+    if (m_mapping != nullptr){
+        munmap(m_mapping, m_mappingBytes);
+    }
+#endif
+    m_mapping = nullptr;
+    m_mappingBytes = 0;
+    m_entries = nullptr;
+    m_moves = nullptr;
+}
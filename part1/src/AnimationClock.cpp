@@ -0,0 +1,29 @@
+#include "AnimationClock.hpp"
+
+AnimationClock::AnimationClock(double stepSeconds):m_stepSeconds(stepSeconds){
+    Reset();
+}
+
+int AnimationClock::Advance(double elapsedSeconds){
+    m_accumulator += elapsedSeconds;
+    int steps = static_cast<int>(m_accumulator / m_stepSeconds);
+    // after a long stall drop the time we cannot catch up on
+    if (steps > MAX_STEPS_PER_FRAME){
+        steps = MAX_STEPS_PER_FRAME;
+        m_accumulator = steps*m_stepSeconds;
+    }
+    m_accumulator -= steps*m_stepSeconds;
+    return steps;
+}
+
+float AnimationClock::Alpha() const{
+    return static_cast<float>(m_accumulator / m_stepSeconds);
+}
+
+double AnimationClock::StepSeconds() const{
+    return m_stepSeconds;
+}
+
+void AnimationClock::Reset(){
+    m_accumulator = 0.0;
+}
@@ -0,0 +1,73 @@
+#include "AnytimeSolver.hpp"
+
+#include <chrono>
+
+AnytimeSolver::AnytimeSolver(const TwoPhaseSolver& solver):m_solver(solver){
+    m_stop = false;
+    m_running = false;
+    m_version = 0;
+}
+
+AnytimeSolver::~AnytimeSolver(){
+    Stop();
+}
+
+void AnytimeSolver::Start(const CubeState& state, int targetLength, double improveSeconds){
+    Stop();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_best.clear();
+        m_version = 0;
+    }
+    m_state = state;
+    m_stop = false;
+    m_running = true;
+    m_thread = std::thread(&AnytimeSolver::Run, this, state, targetLength, improveSeconds);
+}
+
+bool AnytimeSolver::Solve(const CubeState& state, std::vector<Move>& solution, int budgetMilliseconds,
+                          int targetLength, double improveSeconds){
+    Start(state, targetLength, improveSeconds);
+    // the search only ends early if it is done, the budget is the limit
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait_for(lock, std::chrono::milliseconds(budgetMilliseconds), [this]{ return !m_running; });
+    solution = m_best;
+    return m_version > 0;
+}
+
+void AnytimeSolver::Stop(){
+    // the search checks the flag every thousand nodes or so, this is quick
+    m_stop = true;
+    if (m_thread.joinable()){
+        m_thread.join();
+    }
+}
+
+int AnytimeSolver::GetBest(std::vector<Move>& solution) const{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    solution = m_best;
+    return m_version;
+}
+
+bool AnytimeSolver::IsRunning() const{
+    return m_running;
+}
+
+const CubeState& AnytimeSolver::GetState() const{
+    return m_state;
+}
+
+// publishes every improvement, the final solution was published as it was found
+void AnytimeSolver::Run(const CubeState& state, int targetLength, double improveSeconds){
+    std::vector<Move> solution;
+    m_solver.Solve(state, solution, targetLength, improveSeconds, nullptr,
+        [this](const std::vector<Move>& better){
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_best = better;
+            m_version++;
+            m_changed.notify_all();
+        }, &m_stop);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running = false;
+    m_changed.notify_all();
+}
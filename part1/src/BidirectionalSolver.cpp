@@ -0,0 +1,457 @@
+#include "BidirectionalSolver.hpp"
+#include "CubieCube.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <queue>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // states written to a file at a time when merging runs
+    const size_t WRITE_BLOCK = 1 << 16;
+
+    // face turn undoing a face turn, powers 1 2 3 become 3 2 1
+    int InverseFaceMove(int move){
+        return move - move % 3 + 2 - move % 3;
+    }
+
+    // write bytes to a new file, removed again if that fails
+    bool WriteFile(const std::string& path, const char* data, size_t bytes){
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file || !file.write(data, bytes) || !file.flush()){
+            file.close();
+            std::remove(path.c_str());
+            std::cout << "Could not write search states to " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+// corner permutation and twist, then edge permutation and flip, which
+// together take 67 bits
+struct BidirectionalSolver::Key{
+    uint32_t corners;
+    uint32_t edgesHigh;
+    uint32_t edgesLow;
+
+    static Key Of(const CubieCube& cube){
+        uint64_t edges = uint64_t(CubieCube::PermIndex(cube.ep, CubeState::NUM_EDGES))*2048 + cube.Flip();
+        Key key;
+        key.corners = uint32_t(cube.CornerPerm())*2187 + cube.Twist();
+        key.edgesHigh = uint32_t(edges >> 32);
+        key.edgesLow = uint32_t(edges);
+        return key;
+    }
+
+    CubieCube Cube() const{
+        uint64_t edges = (uint64_t(edgesHigh) << 32) | edgesLow;
+        CubieCube cube;
+        cube.SetCornerPerm(corners / 2187);
+        cube.SetTwist(corners % 2187);
+        CubieCube::SetPerm(cube.ep, CubeState::NUM_EDGES, int(edges / 2048), 0);
+        cube.SetFlip(int(edges % 2048));
+        return cube;
+    }
+
+    bool operator<(const Key& other) const{
+        if (corners != other.corners){
+            return corners < other.corners;
+        }
+        if (edgesHigh != other.edgesHigh){
+            return edgesHigh < other.edgesHigh;
+        }
+        return edgesLow < other.edgesLow;
+    }
+    bool operator==(const Key& other) const{
+        return corners == other.corners && edgesHigh == other.edgesHigh && edgesLow == other.edgesLow;
+    }
+};
+
+struct BidirectionalSolver::StateSet{
+    // states held in memory, empty if they are mapped from path
+    std::vector<Key> keys;
+    // the sorted states, in keys or in the mapping
+    const Key* data = nullptr;
+    uint64_t size = 0;
+    // file the states are in, removed with the set, empty if there is none
+    std::string path;
+    void* mapping = nullptr;
+    size_t mappingBytes = 0;
+
+    StateSet() = default;
+    StateSet(const StateSet&) = delete;
+    StateSet& operator=(const StateSet&) = delete;
+    ~StateSet();
+
+    // Take over sorted states held in memory
+    void Hold(std::vector<Key>& sorted);
+    // Use the sorted states written to a file, false with a message if
+    // it can not be read. The file is removed with the set either way.
+    bool Map(const std::string& filePath);
+    bool Contains(const Key& key) const{
+        return std::binary_search(data, data + size, key);
+    }
+    // A state both sets hold, false if there is none
+    bool FindCommon(const StateSet& other, Key& common) const;
+};
+
+BidirectionalSolver::StateSet::~StateSet(){
+#if !defined(_WIN32)
+    if (mapping != nullptr){
+        munmap(mapping, mappingBytes);
+    }
+#endif
+    if (!path.empty()){
+        std::remove(path.c_str());
+    }
+}
+
+void BidirectionalSolver::StateSet::Hold(std::vector<Key>& sorted){
+    keys.swap(sorted);
+    keys.shrink_to_fit();
+    data = keys.data();
+    size = keys.size();
+}
+
+bool BidirectionalSolver::StateSet::Map(const std::string& filePath){
+    path = filePath;
+#if defined(_WIN32)
+    // no mmap here, read the states instead
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (file){
+        size = uint64_t(file.tellg())/sizeof(Key);
+        keys.resize(size);
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(keys.data()), size*sizeof(Key));
+    }
+    if (!file){
+        std::cout << "Could not read search states from " << path << std::endl;
+        return false;
+    }
+    data = keys.data();
+#else
+    int descriptor = open(path.c_str(), O_RDONLY);
+    struct stat status;
+    if (descriptor < 0 || fstat(descriptor, &status) != 0){
+        if (descriptor >= 0){
+            close(descriptor);
+        }
+        std::cout << "Could not read search states from " << path << std::endl;
+        return false;
+    }
+    size = uint64_t(status.st_size)/sizeof(Key);
+    if (size > 0){
+        void* mapped = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+        if (mapped == MAP_FAILED){
+            close(descriptor);
+            size = 0;
+            std::cout << "Could not map search states from " << path << std::endl;
+            return false;
+        }
+        mapping = mapped;
+        mappingBytes = status.st_size;
+        data = static_cast<const Key*>(mapping);
+    }
+    // the mapping stays valid once the file is closed
+    close(descriptor);
+#endif
+    return true;
+}
+
+bool BidirectionalSolver::StateSet::FindCommon(const StateSet& other, Key& common) const{
+    // look the smaller set up in the larger one
+    const StateSet& small = size <= other.size ? *this : other;
+    const StateSet& large = size <= other.size ? other : *this;
+    for (uint64_t i=0; i<small.size; i++){
+        if (large.Contains(small.data[i])){
+            common = small.data[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+struct BidirectionalSolver::Meeting{
+    bool found = false;
+    // the state both sides reach
+    Key key;
+    // for a state found while growing a side: the state of its deepest
+    // level it came from, and the move; move is -1 otherwise
+    Key parent;
+    int move = -1;
+};
+
+BidirectionalSolver::BidirectionalSolver(size_t memoryBytes, const std::string& workDirectory)
+    :m_memoryBytes(memoryBytes), m_workDirectory(workDirectory){}
+
+BidirectionalSolver::~BidirectionalSolver(){}
+
+std::string BidirectionalSolver::FilePath(const std::string& name, int depth, int run) const{
+    std::string path = m_workDirectory + "/bidirectional-" + name + "-" + std::to_string(depth);
+    return run >= 0 ? path + ".run" + std::to_string(run) : path + ".level";
+}
+
+bool BidirectionalSolver::Expand(Side& side, const std::string& name, const StateSet& other,
+                                 Meeting& meeting, Statistics& statistics) const{
+    int depth = side.size();
+    const StateSet& current = *side.back();
+    const StateSet* previous = side.size() > 1 ? side[side.size()-2].get() : nullptr;
+    // room for at least the children of one state
+    size_t capacity = std::max<size_t>(m_memoryBytes/sizeof(Key), 2*CubeState::NUM_FACE_MOVES);
+    std::vector<Key> buffer;
+    buffer.reserve(std::min<uint64_t>(capacity, current.size*CubeState::NUM_FACE_MOVES));
+    Side runs;
+
+    // neighbors of a level are one closer, as far, or one further, so the
+    // new states are the ones in neither the current nor the previous
+    // level. The buffer is sorted, so both sets are walked in order rather
+    // than searched, and so is the other side: the first state it holds
+    // ends the search.
+    auto compact = [&](){
+        std::sort(buffer.begin(), buffer.end());
+        buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+        const StateSet* seen[2] = {&current, previous};
+        for (const StateSet* set : seen){
+            if (set == nullptr){
+                continue;
+            }
+            const Key* next = set->data;
+            const Key* end = set->data + set->size;
+            buffer.erase(std::remove_if(buffer.begin(), buffer.end(), [&](const Key& key){
+                while (next != end && *next < key){
+                    ++next;
+                }
+                return next != end && *next == key;
+            }), buffer.end());
+        }
+        const Key* next = other.data;
+        const Key* end = other.data + other.size;
+        for (const Key& key : buffer){
+            while (next != end && *next < key){
+                ++next;
+            }
+            if (next == end){
+                break;
+            }
+            if (*next == key){
+                meeting.found = true;
+                meeting.key = key;
+                return true;
+            }
+        }
+        return false;
+    };
+    auto spill = [&](){
+        std::string path = FilePath(name, depth, runs.size());
+        if (!WriteFile(path, reinterpret_cast<const char*>(buffer.data()), buffer.size()*sizeof(Key))){
+            return false;
+        }
+        runs.emplace_back(new StateSet());
+        statistics.runs++;
+        statistics.spilledBytes += buffer.size()*sizeof(Key);
+        buffer.clear();
+        return runs.back()->Map(path);
+    };
+
+    for (uint64_t i=0; i<current.size && !meeting.found; i++){
+        CubieCube cube = current.data[i].Cube();
+        for (int move=0; move<CubeState::NUM_FACE_MOVES; move++){
+            buffer.push_back(Key::Of(cube.Multiply(CubieCube::FaceMove(move))));
+        }
+        statistics.states += CubeState::NUM_FACE_MOVES;
+        // spill only once duplicates no longer free half the buffer
+        if (buffer.size() + CubeState::NUM_FACE_MOVES > capacity && !compact()
+            && buffer.size() > capacity/2 && !spill()){
+            return false;
+        }
+    }
+    if (meeting.found || compact()){
+        // the meeting state is one move from the current level
+        CubieCube cube = meeting.key.Cube();
+        for (int move=0; move<CubeState::NUM_FACE_MOVES; move++){
+            Key parent = Key::Of(cube.Multiply(CubieCube::FaceMove(move)));
+            if (current.Contains(parent)){
+                meeting.parent = parent;
+                meeting.move = InverseFaceMove(move);
+                break;
+            }
+        }
+        return true;
+    }
+
+    std::unique_ptr<StateSet> level(new StateSet());
+    if (runs.empty()){
+        level->Hold(buffer);
+        side.push_back(std::move(level));
+        return true;
+    }
+    if (!buffer.empty() && !spill()){
+        return false;
+    }
+    std::vector<Key>().swap(buffer);
+
+    // merge the runs into the level file, dropping states in several runs
+    std::string path = FilePath(name, depth, -1);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    typedef std::pair<Key, size_t> Head;
+    auto later = [](const Head& a, const Head& b){ return b.first < a.first; };
+    std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+    std::vector<uint64_t> positions(runs.size(), 0);
+    for (size_t run=0; run<runs.size(); run++){
+        if (runs[run]->size > 0){
+            heads.push(Head(runs[run]->data[0], run));
+        }
+    }
+    std::vector<Key> block;
+    block.reserve(WRITE_BLOCK);
+    uint64_t written = 0;
+    bool any = false;
+    Key last;
+    while (!heads.empty() && file){
+        Head head = heads.top();
+        heads.pop();
+        size_t run = head.second;
+        if (++positions[run] < runs[run]->size){
+            heads.push(Head(runs[run]->data[positions[run]], run));
+        }
+        if (any && head.first == last){
+            continue;
+        }
+        any = true;
+        last = head.first;
+        block.push_back(head.first);
+        if (block.size() == WRITE_BLOCK){
+            file.write(reinterpret_cast<const char*>(block.data()), block.size()*sizeof(Key));
+            written += block.size();
+            block.clear();
+        }
+    }
+    file.write(reinterpret_cast<const char*>(block.data()), block.size()*sizeof(Key));
+    written += block.size();
+    file.close();
+    if (!file){
+        std::remove(path.c_str());
+        std::cout << "Could not write search states to " << path << std::endl;
+        return false;
+    }
+    statistics.spilledBytes += written*sizeof(Key);
+    if (!level->Map(path)){
+        return false;
+    }
+    side.push_back(std::move(level));
+    return true;
+}
+
+std::vector<Move> BidirectionalSolver::PathTo(const Side& side, int depth, const Key& key) const{
+    std::vector<Move> path(depth);
+    CubieCube cube = key.Cube();
+    // a neighbor one level closer to the root is on a shortest path
+    for (int level=depth; level>0; level--){
+        for (int move=0; move<CubeState::NUM_FACE_MOVES; move++){
+            CubieCube neighbor = cube.Multiply(CubieCube::FaceMove(move));
+            if (side[level-1]->Contains(Key::Of(neighbor))){
+                path[level-1] = static_cast<Move>(InverseFaceMove(move));
+                cube = neighbor;
+                break;
+            }
+        }
+    }
+    return path;
+}
+
+bool BidirectionalSolver::Solve(const CubeState& state, std::vector<Move>& solution,
+                                Statistics* statistics, int maxLength){
+    auto start = std::chrono::steady_clock::now();
+    Statistics local;
+    Statistics& stats = statistics != nullptr ? *statistics : local;
+    stats = Statistics();
+    solution.clear();
+
+    std::vector<Move> rotations;
+    if (!CubieCube::FindCenterRotations(state, rotations)){
+        return false;
+    }
+    CubeState rotated = state;
+    for (Move rotation : rotations){
+        rotated.ApplyMove(rotation);
+    }
+    CubieCube cube = CubieCube::FromState(rotated);
+    if (!cube.IsSolvable()){
+        return false;
+    }
+
+    auto single = [](const CubieCube& root){
+        std::vector<Key> keys(1, Key::Of(root));
+        std::unique_ptr<StateSet> set(new StateSet());
+        set->Hold(keys);
+        return set;
+    };
+    if (m_solved.empty()){
+        m_solved.push_back(single(CubieCube::Solved()));
+    }
+    Side scramble;
+    scramble.push_back(single(cube));
+
+    // every step looks at one more move in total, so the first meeting
+    // is a shortest solution
+    int solvedDepth = 0;
+    bool scrambleGrew = false;
+    Meeting meeting;
+    bool written = true;
+    meeting.found = scramble[0]->FindCommon(*m_solved[0], meeting.key);
+    while (!meeting.found && int(scramble.size()) - 1 + solvedDepth < maxLength){
+        if (solvedDepth + 1 < int(m_solved.size())){
+            // a level kept from an earlier solve costs nothing to grow into
+            solvedDepth++;
+            meeting.found = scramble.back()->FindCommon(*m_solved[solvedDepth], meeting.key);
+        } else if (scramble.back()->size <= m_solved.back()->size){
+            scrambleGrew = true;
+            written = Expand(scramble, "scramble", *m_solved.back(), meeting, stats);
+        } else {
+            scrambleGrew = false;
+            written = Expand(m_solved, "solved", *scramble.back(), meeting, stats);
+            solvedDepth = m_solved.size() - 1;
+        }
+        if (!written){
+            break;
+        }
+    }
+    int scrambleDepth = scramble.size() - 1;
+    stats.scrambleDepth = scrambleDepth;
+    stats.solvedDepth = solvedDepth;
+
+    if (meeting.found){
+        // scramble * forward = key = solved * backward
+        std::vector<Move> forward;
+        std::vector<Move> backward;
+        if (meeting.move >= 0 && scrambleGrew){
+            forward = PathTo(scramble, scrambleDepth, meeting.parent);
+            forward.push_back(static_cast<Move>(meeting.move));
+            backward = PathTo(m_solved, solvedDepth, meeting.key);
+        } else if (meeting.move >= 0){
+            forward = PathTo(scramble, scrambleDepth, meeting.key);
+            backward = PathTo(m_solved, solvedDepth, meeting.parent);
+            backward.push_back(static_cast<Move>(meeting.move));
+        } else {
+            forward = PathTo(scramble, scrambleDepth, meeting.key);
+            backward = PathTo(m_solved, solvedDepth, meeting.key);
+        }
+        solution = rotations;
+        solution.insert(solution.end(), forward.begin(), forward.end());
+        for (auto move = backward.rbegin(); move != backward.rend(); ++move){
+            solution.push_back(static_cast<Move>(InverseFaceMove(static_cast<int>(*move))));
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return meeting.found;
+}
@@ -0,0 +1,700 @@
+#include "CfopSolver.hpp"
+#include "CubieCube.hpp"
+#include "MoveSimplifier.hpp"
+#include "MoveTables.hpp"
+#include "Symmetry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace {
+    // the D edges make the cross, pair k is the D corner 4+k with the
+    // middle edge 8+k (FR FL BL BR)
+    const int FIRST_CROSS_EDGE = 4;
+    const int FIRST_PAIR_CORNER = 4;
+    const int FIRST_PAIR_EDGE = 8;
+    const int ALL_PAIRS = (1 << CfopSolver::NUM_PAIRS) - 1;
+    // positions times flips (or twists) of one piece
+    const int PIECE_STATES = 24;
+    // no pair needs more, the searches stop there
+    const int MAX_PAIR_LENGTH = 14;
+    // the longest sequences the table generator lists
+    const int MAX_TABLE_LENGTH = 20;
+    // last layer sequences the generator joins up, longer ones are only used as they are
+    const int MAX_JOINED_LENGTH = 9;
+    const uint8_t UNKNOWN = 0xFF;
+
+    // where every piece is, indexed by piece: position*2 + flip for edges,
+    // position*3 + twist for corners
+    struct Pieces{
+        uint8_t edges[CubeState::NUM_EDGES];
+        uint8_t corners[CubeState::NUM_CORNERS];
+    };
+
+    Pieces FromCubie(const CubieCube& cube){
+        Pieces pieces;
+        for (int i=0; i<CubeState::NUM_EDGES; i++){
+            pieces.edges[cube.ep[i]] = i*2 + cube.eo[i];
+        }
+        for (int i=0; i<CubeState::NUM_CORNERS; i++){
+            pieces.corners[cube.cp[i]] = i*3 + cube.co[i];
+        }
+        return pieces;
+    }
+
+    CubieCube ToCubie(const Pieces& pieces){
+        CubieCube cube;
+        for (int piece=0; piece<CubeState::NUM_EDGES; piece++){
+            cube.ep[pieces.edges[piece]/2] = piece;
+            cube.eo[pieces.edges[piece]/2] = pieces.edges[piece] % 2;
+        }
+        for (int piece=0; piece<CubeState::NUM_CORNERS; piece++){
+            cube.cp[pieces.corners[piece]/3] = piece;
+            cube.co[pieces.corners[piece]/3] = pieces.corners[piece] % 3;
+        }
+        return cube;
+    }
+
+    struct Tables{
+        // state of one piece after a face turn
+        uint8_t edgeMove[PIECE_STATES][CubeState::NUM_FACE_MOVES];
+        uint8_t cornerMove[PIECE_STATES][CubeState::NUM_FACE_MOVES];
+        // face turns that solve the cross, indexed by SetIndex of the D edges
+        std::vector<uint8_t> cross;
+        // face turns that solve pair k alone, indexed by PairIndex
+        uint8_t pairs[CfopSolver::NUM_PAIRS][PIECE_STATES*PIECE_STATES];
+        // face turns that solve the corners, or the middle edges, of the
+        // pairs in a mask, indexed by SetIndex
+        std::vector<uint8_t> pairCorners[ALL_PAIRS + 1];
+        std::vector<uint8_t> pairEdges[ALL_PAIRS + 1];
+
+        Tables();
+
+        Pieces Turn(const Pieces& pieces, int move) const{
+            Pieces result;
+            for (int i=0; i<CubeState::NUM_EDGES; i++){
+                result.edges[i] = edgeMove[pieces.edges[i]][move];
+            }
+            for (int i=0; i<CubeState::NUM_CORNERS; i++){
+                result.corners[i] = cornerMove[pieces.corners[i]][move];
+            }
+            return result;
+        }
+        // states of the four pieces in a mask, base 24
+        static int SetIndex(const uint8_t* four, int mask){
+            int index = 0;
+            for (int i=0; i<4; i++){
+                if (mask & (1 << i)){
+                    index = index*PIECE_STATES + four[i];
+                }
+            }
+            return index;
+        }
+        static int PairIndex(const Pieces& pieces, int pair){
+            return pieces.corners[FIRST_PAIR_CORNER + pair]*PIECE_STATES + pieces.edges[FIRST_PAIR_EDGE + pair];
+        }
+        int Cross(const Pieces& pieces) const{
+            return cross[SetIndex(pieces.edges + FIRST_CROSS_EDGE, ALL_PAIRS)];
+        }
+        // lower bound on the face turns that solve the pairs in a mask,
+        // the cross not counted
+        int Pairs(const Pieces& pieces, int mask) const{
+            int bound = std::max(pairCorners[mask][SetIndex(pieces.corners + FIRST_PAIR_CORNER, mask)],
+                                 pairEdges[mask][SetIndex(pieces.edges + FIRST_PAIR_EDGE, mask)]);
+            for (int pair=0; pair<CfopSolver::NUM_PAIRS; pair++){
+                if (mask & (1 << pair)){
+                    bound = std::max(bound, int(pairs[pair][PairIndex(pieces, pair)]));
+                }
+            }
+            return bound;
+        }
+        // pairs that are in their slot
+        int SolvedPairs(const Pieces& pieces) const{
+            int mask = 0;
+            for (int pair=0; pair<CfopSolver::NUM_PAIRS; pair++){
+                if (pairs[pair][PairIndex(pieces, pair)] == 0){
+                    mask |= 1 << pair;
+                }
+            }
+            return mask;
+        }
+        // face turns that solve the pieces of the same kind in a mask of
+        // four, moves is edgeMove or cornerMove and solved their solved states
+        std::vector<uint8_t> SetDistances(const uint8_t moves[][CubeState::NUM_FACE_MOVES], const uint8_t* solved, int mask) const;
+    };
+
+    Tables::Tables(){
+        // the face move puts the piece at position ep[to] into position to
+        for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+            const CubieCube& move = CubieCube::FaceMove(m);
+            for (int to=0; to<CubeState::NUM_EDGES; to++){
+                for (int flip=0; flip<2; flip++){
+                    edgeMove[move.ep[to]*2 + flip][m] = to*2 + (flip ^ move.eo[to]);
+                }
+            }
+            for (int to=0; to<CubeState::NUM_CORNERS; to++){
+                for (int twist=0; twist<3; twist++){
+                    cornerMove[move.cp[to]*3 + twist][m] = to*3 + (twist + move.co[to]) % 3;
+                }
+            }
+        }
+
+        Pieces solved = FromCubie(CubieCube::Solved());
+        cross = SetDistances(edgeMove, solved.edges + FIRST_CROSS_EDGE, ALL_PAIRS);
+        for (int mask=1; mask<=ALL_PAIRS; mask++){
+            pairCorners[mask] = SetDistances(cornerMove, solved.corners + FIRST_PAIR_CORNER, mask);
+            pairEdges[mask] = SetDistances(edgeMove, solved.edges + FIRST_PAIR_EDGE, mask);
+        }
+        // every face turn has an inverse, so the distance home is the
+        // distance from home
+        for (int pair=0; pair<CfopSolver::NUM_PAIRS; pair++){
+            std::fill(pairs[pair], pairs[pair] + PIECE_STATES*PIECE_STATES, UNKNOWN);
+            std::vector<int> queue(1, PairIndex(solved, pair));
+            pairs[pair][queue[0]] = 0;
+            for (size_t next=0; next<queue.size(); next++){
+                int corner = queue[next] / PIECE_STATES;
+                int edge = queue[next] % PIECE_STATES;
+                for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+                    int moved = cornerMove[corner][m]*PIECE_STATES + edgeMove[edge][m];
+                    if (pairs[pair][moved] == UNKNOWN){
+                        pairs[pair][moved] = pairs[pair][queue[next]] + 1;
+                        queue.push_back(moved);
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<uint8_t> Tables::SetDistances(const uint8_t moves[][CubeState::NUM_FACE_MOVES], const uint8_t* solved, int mask) const{
+        int count = __builtin_popcount(mask);
+        int size = 1;
+        for (int i=0; i<count; i++){
+            size *= PIECE_STATES;
+        }
+        std::vector<uint8_t> distances(size, UNKNOWN);
+        std::vector<int> queue(1, SetIndex(solved, mask));
+        distances[queue[0]] = 0;
+        for (size_t next=0; next<queue.size(); next++){
+            int index = queue[next];
+            // unpack into the slots of the mask, the others stay unused
+            uint8_t four[4] = {0, 0, 0, 0};
+            for (int i=3; i>=0; i--){
+                if (mask & (1 << i)){
+                    four[i] = index % PIECE_STATES;
+                    index /= PIECE_STATES;
+                }
+            }
+            for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+                uint8_t moved[4];
+                for (int i=0; i<4; i++){
+                    moved[i] = moves[four[i]][m];
+                }
+                int movedIndex = SetIndex(moved, mask);
+                if (distances[movedIndex] == UNKNOWN){
+                    distances[movedIndex] = distances[queue[next]] + 1;
+                    queue.push_back(movedIndex);
+                }
+            }
+        }
+        return distances;
+    }
+
+    const Tables& GetTables(){
+        static const Tables TABLES;
+        return TABLES;
+    }
+
+    // Case of the pair table for a pair, the pairs already solved and the
+    // states of the pair's corner and edge (a PairIndex)
+    int PairCase(int solved, int pair, int pairIndex){
+        return (solved*CfopSolver::NUM_PAIRS + pair)*PIECE_STATES*PIECE_STATES + pairIndex;
+    }
+
+    // The solved cube with the corner and edge of a pair moved to the
+    // states of pairIndex, false if one of them would take the place of a
+    // cross edge or of a piece of the pairs in kept. The pieces that make
+    // room go to the pair's slot, no other piece matters to the case.
+    bool PlacePair(int kept, int pair, int pairIndex, Pieces& pieces){
+        int cornerState = pairIndex / PIECE_STATES;
+        int edgeState = pairIndex % PIECE_STATES;
+        // a solved piece is at the position of its own number
+        int cornerAt = cornerState / 3;
+        int edgeAt = edgeState / 2;
+        for (int other=0; other<CfopSolver::NUM_PAIRS; other++){
+            if ((kept & (1 << other)) && (cornerAt == FIRST_PAIR_CORNER + other || edgeAt == FIRST_PAIR_EDGE + other)){
+                return false;
+            }
+        }
+        if (edgeAt >= FIRST_CROSS_EDGE && edgeAt < FIRST_CROSS_EDGE + 4){
+            return false;
+        }
+        pieces = FromCubie(CubieCube::Solved());
+        std::swap(pieces.corners[cornerAt], pieces.corners[FIRST_PAIR_CORNER + pair]);
+        std::swap(pieces.edges[edgeAt], pieces.edges[FIRST_PAIR_EDGE + pair]);
+        pieces.corners[FIRST_PAIR_CORNER + pair] = cornerState;
+        pieces.edges[FIRST_PAIR_EDGE + pair] = edgeState;
+        return true;
+    }
+
+    // Iterative deepening search for the fewest face turns that solve the
+    // pairs in a mask and keep the cross, only used to fill the pair table
+    struct PairSearch{
+        const Tables& tables;
+        int goal;
+        // the moves found, last one first
+        int path[MAX_PAIR_LENGTH];
+
+        PairSearch(const Tables& t, int mask):tables(t), goal(mask){}
+
+        bool Search(const Pieces& pieces, int depth, int previous){
+            if (std::max(tables.Cross(pieces), tables.Pairs(pieces, goal)) > depth){
+                return false;
+            }
+            if (depth == 0){
+                return true;
+            }
+            for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+                if (MoveTables::RedundantFaceTurn(m, previous)){
+                    continue;
+                }
+                path[depth-1] = m;
+                if (Search(tables.Turn(pieces, m), depth-1, m)){
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    // Lists every sequence up to a length that ends with the first two
+    // layers solved and keeps the shortest (then first in move order) for
+    // each last layer it leaves
+    struct LayerListing{
+        const Tables& tables;
+        int maxLength;
+        // per case, the length and moves of the best sequence so far
+        std::vector<uint8_t> lengths;
+        std::vector<uint8_t> moves;
+        uint8_t path[MAX_TABLE_LENGTH];
+
+        LayerListing(const Tables& t, int length)
+            :tables(t), maxLength(length),
+             lengths(LastLayerTable::NUM_CASES, UNKNOWN), moves(size_t(LastLayerTable::NUM_CASES)*length){}
+
+        // Keep a sequence for a case if it beats the one there
+        void Offer(int signature, const uint8_t* sequence, int length){
+            uint8_t* kept = &moves[size_t(signature)*maxLength];
+            if (length < lengths[signature]
+                || (length == lengths[signature] && std::lexicographical_compare(sequence, sequence + length, kept, kept + length))){
+                lengths[signature] = length;
+                std::copy(sequence, sequence + length, kept);
+            }
+        }
+
+        void Search(const Pieces& pieces, int length, int previous){
+            int bound = std::max(tables.Cross(pieces), tables.Pairs(pieces, ALL_PAIRS));
+            if (bound > maxLength - length){
+                return;
+            }
+            if (bound == 0 && length > 0){
+                Offer(LastLayerTable::Signature(ToCubie(pieces)), path, length);
+            }
+            if (length == maxLength){
+                return;
+            }
+            for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+                if (MoveTables::RedundantFaceTurn(m, previous)){
+                    continue;
+                }
+                path[length] = m;
+                Search(tables.Turn(pieces, m), length+1, m);
+            }
+        }
+    };
+
+    // the last layer of a followed by b, the only part Signature reads
+    CubieCube ComposeLayers(const CubieCube& a, const CubieCube& b){
+        CubieCube result;
+        for (int i=0; i<4; i++){
+            result.cp[i] = a.cp[b.cp[i]];
+            int twist = a.co[b.cp[i]] + b.co[i];
+            result.co[i] = twist >= 3 ? twist - 3 : twist;
+            result.ep[i] = a.ep[b.ep[i]];
+            result.eo[i] = a.eo[b.ep[i]] ^ b.eo[i];
+        }
+        return result;
+    }
+}
+
+CfopSolver::CfopSolver(const std::string& tableDirectory, int threads, bool generateMissing)
+    :m_pairs(NUM_PAIR_CASES, PAIR_TABLE_MAGIC){
+    GetTables();
+    bool pairsLoaded = !tableDirectory.empty() && m_pairs.Load(PairTablePath(tableDirectory));
+    bool lastLayerLoaded = !tableDirectory.empty() && m_lastLayer.Load(TablePath(tableDirectory));
+    if (generateMissing && !pairsLoaded){
+        GeneratePairTable(m_pairs, threads);
+    }
+    if (generateMissing && !lastLayerLoaded){
+        GenerateTable(m_lastLayer, STARTUP_TABLE_LENGTH, threads);
+    }
+}
+
+bool CfopSolver::Solve(const CubeState& state, std::vector<Move>& solution, Stages* stages) const{
+    solution.clear();
+    std::vector<Move> rotations;
+    if (!CubieCube::FindCenterRotations(state, rotations)){
+        return false;
+    }
+    CubeState rotated = state;
+    for (Move rotation : rotations){
+        rotated.ApplyMove(rotation);
+    }
+    CubieCube cube = CubieCube::FromState(rotated);
+    if (!cube.IsSolvable()){
+        return false;
+    }
+
+    const Tables& tables = GetTables();
+    Stages counts;
+    Pieces pieces = FromCubie(cube);
+    std::vector<Move> turns;
+
+    // the cross table is exact, some turn is always one closer
+    for (int distance = tables.Cross(pieces); distance > 0; distance--){
+        for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+            Pieces moved = tables.Turn(pieces, m);
+            if (tables.Cross(moved) == distance - 1){
+                pieces = moved;
+                turns.push_back(static_cast<Move>(m));
+                break;
+            }
+        }
+    }
+    counts.cross = turns.size();
+
+    // each pair is one lookup, the one with the shortest algorithm first
+    int solved = tables.SolvedPairs(pieces);
+    for (int step=0; solved != ALL_PAIRS; step++){
+        int best = -1;
+        int bestLength = 0;
+        for (int pair=0; pair<NUM_PAIRS; pair++){
+            if (solved & (1 << pair)){
+                continue;
+            }
+            int length = m_pairs.Length(PairCase(solved, pair, Tables::PairIndex(pieces, pair)));
+            if (length >= 0 && (best < 0 || length < bestLength)){
+                best = pair;
+                bestLength = length;
+            }
+        }
+        if (best < 0){
+            return false;
+        }
+        size_t start = turns.size();
+        m_pairs.Lookup(PairCase(solved, best, Tables::PairIndex(pieces, best)), turns);
+        for (size_t i=start; i<turns.size(); i++){
+            pieces = tables.Turn(pieces, static_cast<int>(turns[i]));
+        }
+        counts.pairs[step] = bestLength;
+        // the algorithm keeps the solved pairs and may solve others on the way
+        solved = tables.SolvedPairs(pieces);
+    }
+
+    size_t firstLayerTurns = turns.size();
+    if (!m_lastLayer.Lookup(LastLayerTable::Signature(ToCubie(pieces)), turns)){
+        return false;
+    }
+    counts.lastLayer = turns.size() - firstLayerTurns;
+
+    // a stage may start by turning the face the one before ended with
+    MoveSimplifier::Simplify(turns, MoveSimplifier::Metric::HTM);
+    solution = rotations;
+    solution.insert(solution.end(), turns.begin(), turns.end());
+    if (stages != nullptr){
+        *stages = counts;
+    }
+    return true;
+}
+
+const LastLayerTable& CfopSolver::Table() const{
+    return m_lastLayer;
+}
+
+const AlgorithmTable& CfopSolver::PairTable() const{
+    return m_pairs;
+}
+
+bool CfopSolver::TableLoaded() const{
+    return m_lastLayer.IsMapped() && m_pairs.IsMapped();
+}
+
+bool CfopSolver::HasTables() const{
+    return m_lastLayer.Bytes() > 0 && m_pairs.Bytes() > 0;
+}
+
+size_t CfopSolver::MemoryFootprint() const{
+    const Tables& tables = GetTables();
+    size_t bytes = sizeof(Tables) + tables.cross.size() + m_lastLayer.Bytes() + m_pairs.Bytes();
+    for (int mask=1; mask<=ALL_PAIRS; mask++){
+        bytes += tables.pairCorners[mask].size() + tables.pairEdges[mask].size();
+    }
+    return bytes;
+}
+
+void CfopSolver::GenerateTable(LastLayerTable& table, int maxLength, int threads){
+    if (threads <= 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    maxLength = std::max(1, std::min(maxLength, MAX_TABLE_LENGTH));
+    const Tables& tables = GetTables();
+    Pieces solvedPieces = FromCubie(CubieCube::Solved());
+
+    // each thread lists the sequences that start with its share of the
+    // first moves, the best of every thread is kept in the end
+    std::vector<std::unique_ptr<LayerListing>> listings;
+    for (int thread=0; thread<threads; thread++){
+        listings.emplace_back(new LayerListing(tables, maxLength));
+    }
+    auto list = [&](int thread){
+        LayerListing& listing = *listings[thread];
+        for (int m=thread; m<CubeState::NUM_FACE_MOVES; m+=threads){
+            listing.path[0] = m;
+            listing.Search(tables.Turn(solvedPieces, m), 1, m);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int thread=1; thread<threads; thread++){
+        workers.emplace_back(list, thread);
+    }
+    list(0);
+    for (std::thread& worker : workers){
+        worker.join();
+    }
+    LayerListing& best = *listings[0];
+    for (int thread=1; thread<threads; thread++){
+        for (int signature=0; signature<LastLayerTable::NUM_CASES; signature++){
+            if (listings[thread]->lengths[signature] != UNKNOWN){
+                best.Offer(signature, &listings[thread]->moves[size_t(signature)*maxLength], listings[thread]->lengths[signature]);
+            }
+        }
+        listings[thread].reset();
+    }
+    best.lengths[0] = 0;
+
+    // the sequences that take the solved cube to each case; the cases no
+    // listed sequence reaches are joined from short ones, cheapest first
+    // (Dijkstra with a queue per cost), each case remembers the case and
+    // the sequence it came from
+    std::vector<CubieCube> cases(LastLayerTable::NUM_CASES);
+    std::vector<int> joined;
+    for (int signature=0; signature<LastLayerTable::NUM_CASES; signature++){
+        cases[signature] = LastLayerTable::CaseCube(signature);
+        if (best.lengths[signature] != UNKNOWN && best.lengths[signature] > 0
+            && best.lengths[signature] <= MAX_JOINED_LENGTH){
+            joined.push_back(signature);
+        }
+    }
+    std::vector<int> cost(LastLayerTable::NUM_CASES, -1);
+    std::vector<int> from(LastLayerTable::NUM_CASES, -1);
+    std::vector<int> via(LastLayerTable::NUM_CASES, -1);
+    std::vector<std::vector<int>> queues(1);
+    for (int signature=0; signature<LastLayerTable::NUM_CASES; signature++){
+        if (best.lengths[signature] != UNKNOWN){
+            cost[signature] = best.lengths[signature];
+            queues.resize(std::max(queues.size(), size_t(cost[signature] + 1)));
+            queues[cost[signature]].push_back(signature);
+        }
+    }
+    for (size_t current=0; current<queues.size(); current++){
+        for (size_t i=0; i<queues[current].size(); i++){
+            int signature = queues[current][i];
+            if (cost[signature] != int(current)){
+                continue;
+            }
+            for (int step : joined){
+                int next = LastLayerTable::Signature(ComposeLayers(cases[signature], cases[step]));
+                int nextCost = current + best.lengths[step];
+                if (cost[next] < 0 || nextCost < cost[next]){
+                    cost[next] = nextCost;
+                    from[next] = signature;
+                    via[next] = step;
+                    queues.resize(std::max(queues.size(), size_t(nextCost + 1)));
+                    queues[nextCost].push_back(next);
+                }
+            }
+        }
+    }
+
+    // an algorithm undoes the sequences that lead to its case
+    std::vector<std::vector<Move>> algorithms(LastLayerTable::NUM_CASES);
+    for (int signature=0; signature<LastLayerTable::NUM_CASES; signature++){
+        if (cost[signature] < 0){
+            continue;
+        }
+        std::vector<Move>& algorithm = algorithms[signature];
+        for (int step = signature; step > 0; step = from[step]){
+            int sequence = via[step] < 0 ? step : via[step];
+            const uint8_t* moves = &best.moves[size_t(sequence)*maxLength];
+            for (int i=best.lengths[sequence]-1; i>=0; i--){
+                algorithm.push_back(MoveTables::Inverse(static_cast<Move>(moves[i])));
+            }
+            if (via[step] < 0){
+                break;
+            }
+        }
+        MoveSimplifier::Simplify(algorithm, MoveSimplifier::Metric::HTM);
+    }
+    listings[0].reset();
+    table.Reset(algorithms);
+}
+
+void CfopSolver::GeneratePairTable(AlgorithmTable& table, int threads){
+    if (threads <= 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const Tables& tables = GetTables();
+
+    // every case of the first pair a cube with the cross solved can be in
+    // (the masks without it are the even ones), searched by whichever
+    // thread takes it next
+    std::vector<int> cases;
+    for (int solved=0; solved<ALL_PAIRS; solved+=2){
+        for (int pairIndex=0; pairIndex<PIECE_STATES*PIECE_STATES; pairIndex++){
+            Pieces pieces;
+            if (PlacePair(solved, 0, pairIndex, pieces)){
+                cases.push_back(PairCase(solved, 0, pairIndex));
+            }
+        }
+    }
+    std::vector<std::vector<Move>> algorithms(NUM_PAIR_CASES);
+    std::atomic<size_t> next(0);
+    auto search = [&](){
+        for (size_t i = next++; i < cases.size(); i = next++){
+            int pairIndex = cases[i] % (PIECE_STATES*PIECE_STATES);
+            int solved = cases[i] / (PIECE_STATES*PIECE_STATES) / NUM_PAIRS;
+            Pieces pieces;
+            PlacePair(solved, 0, pairIndex, pieces);
+            PairSearch pairSearch(tables, solved | 1);
+            for (int depth=0; depth<=MAX_PAIR_LENGTH; depth++){
+                if (pairSearch.Search(pieces, depth, -1)){
+                    for (int move=depth-1; move>=0; move--){
+                        algorithms[cases[i]].push_back(static_cast<Move>(pairSearch.path[move]));
+                    }
+                    break;
+                }
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int thread=1; thread<threads; thread++){
+        workers.emplace_back(search);
+    }
+    search();
+    for (std::thread& worker : workers){
+        worker.join();
+    }
+
+    // the other pairs' cases are the first pair's turned about the U-D
+    // axis, or mirrored: find a symmetry that takes each slot to the
+    // first one, and where it takes the other slots. Pair index 0 has the
+    // corner and edge in the U layer.
+    const int inTopLayer = 0;
+    int symmetries[NUM_PAIRS];
+    int slots[NUM_PAIRS][NUM_PAIRS];
+    for (int pair=1; pair<NUM_PAIRS; pair++){
+        for (int symmetry=0; symmetry<Symmetry::NUM_UD_SYMMETRIES; symmetry++){
+            // the pair whose corner and edge a cube has in the U layer
+            for (int other=0; other<NUM_PAIRS; other++){
+                Pieces pieces;
+                PlacePair(0, other, inTopLayer, pieces);
+                Pieces turned = FromCubie(Symmetry::Conjugate(ToCubie(pieces), symmetry));
+                slots[pair][other] = __builtin_ctz(ALL_PAIRS & ~tables.SolvedPairs(turned));
+            }
+            if (slots[pair][pair] == 0){
+                symmetries[pair] = symmetry;
+                break;
+            }
+        }
+        int symmetry = symmetries[pair];
+        for (int solved=0; solved<ALL_PAIRS; solved++){
+            if (solved & (1 << pair)){
+                continue;
+            }
+            int turnedSolved = 0;
+            for (int other=0; other<NUM_PAIRS; other++){
+                if (solved & (1 << other)){
+                    turnedSolved |= 1 << slots[pair][other];
+                }
+            }
+            for (int pairIndex=0; pairIndex<PIECE_STATES*PIECE_STATES; pairIndex++){
+                Pieces pieces;
+                if (!PlacePair(solved, pair, pairIndex, pieces)){
+                    continue;
+                }
+                Pieces turned = FromCubie(Symmetry::Conjugate(ToCubie(pieces), symmetry));
+                // S^-1 A S solves the case when A solves S C S^-1
+                const std::vector<Move>& turnedAlgorithm = algorithms[PairCase(turnedSolved, 0, Tables::PairIndex(turned, 0))];
+                std::vector<Move>& algorithm = algorithms[PairCase(solved, pair, pairIndex)];
+                for (Move move : turnedAlgorithm){
+                    algorithm.push_back(static_cast<Move>(Symmetry::ConjugateMove(static_cast<int>(move), Symmetry::Inverse(symmetry))));
+                }
+            }
+        }
+    }
+    table.Reset(algorithms);
+}
+
+int CfopSolver::CheckPairTable(const AlgorithmTable& table, int* cases){
+    int wrong = 0;
+    int checked = 0;
+    std::vector<Move> algorithm;
+    for (int solved=0; solved<ALL_PAIRS; solved++){
+        for (int pair=0; pair<NUM_PAIRS; pair++){
+            if (solved & (1 << pair)){
+                continue;
+            }
+            int goal = solved | (1 << pair);
+            for (int pairIndex=0; pairIndex<PIECE_STATES*PIECE_STATES; pairIndex++){
+                Pieces pieces;
+                if (!PlacePair(solved, pair, pairIndex, pieces) || pairIndex == Tables::PairIndex(FromCubie(CubieCube::Solved()), pair)){
+                    continue;
+                }
+                checked++;
+                algorithm.clear();
+                if (!table.Lookup(PairCase(solved, pair, pairIndex), algorithm)){
+                    wrong++;
+                    continue;
+                }
+                // turned as a whole cube, not with the tables the search used
+                CubieCube cube = ToCubie(pieces);
+                for (Move move : algorithm){
+                    cube = cube.Multiply(CubieCube::FaceMove(static_cast<int>(move)));
+                }
+                bool kept = true;
+                for (int i=0; i<4; i++){
+                    kept &= cube.ep[FIRST_CROSS_EDGE + i] == FIRST_CROSS_EDGE + i && cube.eo[FIRST_CROSS_EDGE + i] == 0;
+                    if (goal & (1 << i)){
+                        kept &= cube.cp[FIRST_PAIR_CORNER + i] == FIRST_PAIR_CORNER + i && cube.co[FIRST_PAIR_CORNER + i] == 0;
+                        kept &= cube.ep[FIRST_PAIR_EDGE + i] == FIRST_PAIR_EDGE + i && cube.eo[FIRST_PAIR_EDGE + i] == 0;
+                    }
+                }
+                wrong += !kept;
+            }
+        }
+    }
+    if (cases != nullptr){
+        *cases = checked;
+    }
+    return wrong;
+}
+
+std::string CfopSolver::TablePath(const std::string& tableDirectory){
+    return tableDirectory + "/lastlayer.lla";
+}
+
+std::string CfopSolver::PairTablePath(const std::string& tableDirectory){
+    return tableDirectory + "/pairs.lla";
+}
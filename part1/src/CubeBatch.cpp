@@ -0,0 +1,178 @@
+#include "CubeBatch.hpp"
+#include "MoveTables.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define CUBEBATCH_X86
+    #include <immintrin.h>
+#endif
+
+namespace {
+    // orientation wraps at 3*8 for corners and at 32 for everything else
+    // (edge flip is bit 4, center spin is bits 3-4)
+    alignas(32) const uint8_t WRAP_LIMITS[CubeState::PACKED_SIZE] = {
+        32,32,32,32, 32,32,32,32, 32,32,32,32, 32,32,32,32,
+        24,24,24,24, 24,24,24,24, 32,32,32,32, 32,32,32,32
+    };
+
+#ifdef CUBEBATCH_X86
+    // One lane of 16 bytes: shuffle, add orientation, wrap.
+    // pshufb only looks at the low 4 bits of each index, so the
+    // move table indices 16-31 work unchanged for the second lane.
+    __attribute__((target("ssse3")))
+    inline __m128i MoveLane128(__m128i state, __m128i perm, __m128i add, __m128i limit){
+        __m128i v = _mm_add_epi8(_mm_shuffle_epi8(state, perm), add);
+        __m128i over = _mm_cmpgt_epi8(v, _mm_sub_epi8(limit, _mm_set1_epi8(1)));
+        return _mm_sub_epi8(v, _mm_and_si128(over, limit));
+    }
+
+    __attribute__((target("ssse3")))
+    void ApplyMoveSSSE3(uint8_t* bytes, size_t count, Move move){
+        const MoveTables::MoveTable& table = MoveTables::TABLES.moves[static_cast<int>(move)];
+        const __m128i permLo = _mm_loadu_si128((const __m128i*)table.perm);
+        const __m128i permHi = _mm_loadu_si128((const __m128i*)(table.perm+16));
+        const __m128i addLo = _mm_loadu_si128((const __m128i*)table.add);
+        const __m128i addHi = _mm_loadu_si128((const __m128i*)(table.add+16));
+        const __m128i limitLo = _mm_load_si128((const __m128i*)WRAP_LIMITS);
+        const __m128i limitHi = _mm_load_si128((const __m128i*)(WRAP_LIMITS+16));
+        for (size_t i=0; i<count; i++){
+            __m128i* state = (__m128i*)(bytes + i*CubeState::PACKED_SIZE);
+            _mm_store_si128(state, MoveLane128(_mm_load_si128(state), permLo, addLo, limitLo));
+            _mm_store_si128(state+1, MoveLane128(_mm_load_si128(state+1), permHi, addHi, limitHi));
+        }
+    }
+
+    __attribute__((target("ssse3")))
+    void ApplyMovesSSSE3(uint8_t* bytes, const Move* moves, size_t count){
+        const __m128i limitLo = _mm_load_si128((const __m128i*)WRAP_LIMITS);
+        const __m128i limitHi = _mm_load_si128((const __m128i*)(WRAP_LIMITS+16));
+        for (size_t i=0; i<count; i++){
+            const MoveTables::MoveTable& table = MoveTables::TABLES.moves[static_cast<int>(moves[i])];
+            __m128i* state = (__m128i*)(bytes + i*CubeState::PACKED_SIZE);
+            _mm_store_si128(state, MoveLane128(_mm_load_si128(state),
+                _mm_loadu_si128((const __m128i*)table.perm),
+                _mm_loadu_si128((const __m128i*)table.add), limitLo));
+            _mm_store_si128(state+1, MoveLane128(_mm_load_si128(state+1),
+                _mm_loadu_si128((const __m128i*)(table.perm+16)),
+                _mm_loadu_si128((const __m128i*)(table.add+16)), limitHi));
+        }
+    }
+
+    // a whole state fits in one register, vpshufb shuffles each 16 byte lane on its own
+    __attribute__((target("avx2")))
+    inline __m256i MoveState256(__m256i state, __m256i perm, __m256i add, __m256i limit){
+        __m256i v = _mm256_add_epi8(_mm256_shuffle_epi8(state, perm), add);
+        __m256i over = _mm256_cmpgt_epi8(v, _mm256_sub_epi8(limit, _mm256_set1_epi8(1)));
+        return _mm256_sub_epi8(v, _mm256_and_si256(over, limit));
+    }
+
+    __attribute__((target("avx2")))
+    void ApplyMoveAVX2(uint8_t* bytes, size_t count, Move move){
+        const MoveTables::MoveTable& table = MoveTables::TABLES.moves[static_cast<int>(move)];
+        const __m256i perm = _mm256_loadu_si256((const __m256i*)table.perm);
+        const __m256i add = _mm256_loadu_si256((const __m256i*)table.add);
+        const __m256i limit = _mm256_load_si256((const __m256i*)WRAP_LIMITS);
+        for (size_t i=0; i<count; i++){
+            __m256i* state = (__m256i*)(bytes + i*CubeState::PACKED_SIZE);
+            _mm256_store_si256(state, MoveState256(_mm256_load_si256(state), perm, add, limit));
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void ApplyMovesAVX2(uint8_t* bytes, const Move* moves, size_t count){
+        const __m256i limit = _mm256_load_si256((const __m256i*)WRAP_LIMITS);
+        for (size_t i=0; i<count; i++){
+            const MoveTables::MoveTable& table = MoveTables::TABLES.moves[static_cast<int>(moves[i])];
+            __m256i* state = (__m256i*)(bytes + i*CubeState::PACKED_SIZE);
+            _mm256_store_si256(state, MoveState256(_mm256_load_si256(state),
+                _mm256_loadu_si256((const __m256i*)table.perm),
+                _mm256_loadu_si256((const __m256i*)table.add), limit));
+        }
+    }
+#endif
+}
+
+void CubeBatch::ApplyMove(CubeState* states, size_t count, Move move){
+    ApplyMove(states, count, move, Best());
+}
+
+void CubeBatch::ApplyMove(CubeState* states, size_t count, Move move, Implementation implementation){
+    // never run instructions the CPU does not have
+    if (!Supported(implementation)){
+        implementation = Implementation::SCALAR;
+    }
+#ifdef CUBEBATCH_X86
+    if (implementation == Implementation::AVX2){
+        ApplyMoveAVX2(Bytes(states), count, move);
+        return;
+    }
+    if (implementation == Implementation::SSSE3){
+        ApplyMoveSSSE3(Bytes(states), count, move);
+        return;
+    }
+#endif
+    for (size_t i=0; i<count; i++){
+        states[i].ApplyMove(move);
+    }
+}
+
+void CubeBatch::ApplyMoves(CubeState* states, const Move* moves, size_t count){
+    ApplyMoves(states, moves, count, Best());
+}
+
+void CubeBatch::ApplyMoves(CubeState* states, const Move* moves, size_t count, Implementation implementation){
+    // never run instructions the CPU does not have
+    if (!Supported(implementation)){
+        implementation = Implementation::SCALAR;
+    }
+#ifdef CUBEBATCH_X86
+    if (implementation == Implementation::AVX2){
+        ApplyMovesAVX2(Bytes(states), moves, count);
+        return;
+    }
+    if (implementation == Implementation::SSSE3){
+        ApplyMovesSSSE3(Bytes(states), moves, count);
+        return;
+    }
+#endif
+    for (size_t i=0; i<count; i++){
+        states[i].ApplyMove(moves[i]);
+    }
+}
+
+CubeBatch::Implementation CubeBatch::Best(){
+    static const Implementation best =
+        Supported(Implementation::AVX2) ? Implementation::AVX2 :
+        Supported(Implementation::SSSE3) ? Implementation::SSSE3 :
+        Implementation::SCALAR;
+    return best;
+}
+
+bool CubeBatch::Supported(Implementation implementation){
+    switch(implementation){
+#ifdef CUBEBATCH_X86
+        case Implementation::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case Implementation::SSSE3:
+            return __builtin_cpu_supports("ssse3");
+#endif
+        case Implementation::SCALAR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+const char* CubeBatch::Name(Implementation implementation){
+    switch(implementation){
+        case Implementation::AVX2:
+            return "avx2";
+        case Implementation::SSSE3:
+            return "ssse3";
+        default:
+            return "scalar";
+    }
+}
+
+uint8_t* CubeBatch::Bytes(CubeState* state){
+    return state->m_cubies;
+}
@@ -0,0 +1,192 @@
+#include "CubeSimulation.hpp"
+#include "MoveTables.hpp"
+#include "ZobristHash.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // rotation type used by Transform for each move axis (x, y, z)
+    const Transform::RotationType AXIS_ROTATION_TYPES[3] = {
+        Transform::RotationType::YAW,
+        Transform::RotationType::PITCH,
+        Transform::RotationType::ROLL
+    };
+}
+
+CubeSimulation::CubeSimulation(){
+    m_activeMove = Move::U;
+    m_rotating = false;
+    m_previousAngle = 0.0f;
+    m_rotationAngle = 0.0f;
+    m_turnDuration = 0.5f;
+    m_collapseQueuedMoves = false;
+    m_completedMoves = 0;
+    m_stateHash = ZobristHash::Compute(m_cubeState);
+    m_countStateVisits = false;
+}
+
+void CubeSimulation::Step(float seconds){
+    m_previousAngle = m_rotationAngle;
+
+    // start the next queued move as soon as the previous one has finished
+    if (!m_rotating && m_moveQueue.Pop(m_activeMove)) {
+        m_rotating = true;
+        m_rotationAngle = m_previousAngle = 0.0f;
+    }
+    if (!m_rotating) {
+        return;
+    }
+
+    // a quarter turn takes m_turnDuration seconds, half turns simply turn twice as far
+    float targetAngle = std::abs(MoveTables::QuarterTurns(m_activeMove))*M_PI_2;
+    float angularSpeed = M_PI_2/m_turnDuration*GetSpeedMultiplier();
+    m_rotationAngle = std::min(m_rotationAngle + angularSpeed*seconds, targetAngle);
+
+    // reached the target angle => rotation has finished
+    if (m_rotationAngle >= targetAngle) {
+        FinishMove();
+    }
+}
+
+void CubeSimulation::ComputeTransforms(float alpha){
+    // interpolate between the last two steps so motion stays smooth
+    // when the frame rate and the step rate do not line up
+    float rotationAmount = m_previousAngle + (m_rotationAngle - m_previousAngle)*alpha;
+
+    // the move being animated, its axis and direction come from the move tables
+    float angle = MoveTables::QuarterTurns(m_activeMove) < 0 ? -rotationAmount : rotationAmount;
+    glm::vec3 axis(0.0f,0.0f,0.0f);
+    axis[MoveTables::Axis(m_activeMove)] = 1.0f;
+
+    // link absolute position to current subcube
+    for(int i=0; i<NUM_SUB_CUBES; i++) {
+        MoveTables::Vec3 slot = MoveTables::SlotPosition(i);
+        Transform& transform = m_transforms[m_cubeState.CubieAt(i)];
+
+        // note: this is the identity + identity rotation already
+        transform.LoadIdentity();
+
+        if (m_rotating && MoveTables::MovesSlot(m_activeMove, i)) {
+            // if actively rotating -> rotate then translate to achieve "orbit" effect
+            transform.Rotate(angle, axis);
+        }
+
+        // translate the sub cube to the absolute cube position
+        transform.Translate(slot.v[0], slot.v[1], slot.v[2]);
+        // perform final rotations to make sure cube is facing right direction when rotation completes
+        transform.ApplyIdentityRotation();
+        // scale the cubes
+        transform.Scale(.49f,.49f,.49f);
+    }
+}
+
+const Transform& CubeSimulation::GetTransform(int subCube) const{
+    return m_transforms[subCube];
+}
+
+bool CubeSimulation::QueueMove(Move move){
+    return m_moveQueue.Push(move);
+}
+
+void CubeSimulation::ClearQueue(){
+    m_moveQueue.Clear();
+}
+
+int CubeSimulation::QueuedMoves() const{
+    return m_moveQueue.Size();
+}
+
+bool CubeSimulation::IsRotating() const{
+    return m_rotating;
+}
+
+long long CubeSimulation::CompletedMoves() const{
+    return m_completedMoves;
+}
+
+const CubeState& CubeSimulation::GetCubeState() const{
+    return m_cubeState;
+}
+
+CubeState CubeSimulation::GetQueuedState() const{
+    CubeState state = m_cubeState;
+    if (m_rotating) {
+        state.ApplyMove(m_activeMove);
+    }
+    for(int i=0; i<m_moveQueue.Size(); i++){
+        state.ApplyMove(m_moveQueue.Peek(i));
+    }
+    return state;
+}
+
+uint64_t CubeSimulation::GetStateHash() const{
+    return m_stateHash;
+}
+
+int CubeSimulation::GetStateVisits() const{
+    const int* visits = m_stateVisits.Find(m_stateHash);
+    return visits != nullptr ? *visits : 0;
+}
+
+size_t CubeSimulation::DistinctStates() const{
+    return m_stateVisits.Size();
+}
+
+void CubeSimulation::SetCountStateVisits(bool count){
+    m_countStateVisits = count;
+    // a fresh table gives back the memory of the old one
+    m_stateVisits = TranspositionTable<int>();
+    if (count){
+        m_stateVisits[m_stateHash] = 1;
+    }
+}
+
+bool CubeSimulation::GetCountStateVisits() const{
+    return m_countStateVisits;
+}
+
+void CubeSimulation::SetTurnDuration(float seconds){
+    m_turnDuration = std::min(std::max(seconds, MIN_TURN_DURATION), MAX_TURN_DURATION);
+}
+
+float CubeSimulation::GetTurnDuration() const{
+    return m_turnDuration;
+}
+
+void CubeSimulation::SetCollapseQueuedMoves(bool collapse){
+    m_collapseQueuedMoves = collapse;
+}
+
+bool CubeSimulation::GetCollapseQueuedMoves() const{
+    return m_collapseQueuedMoves;
+}
+
+void CubeSimulation::FinishMove(){
+    // update identity rotation for rotated cubes
+    for(int i=0; i<NUM_SUB_CUBES; i++){
+        if (MoveTables::MovesSlot(m_activeMove, i)) {
+            m_transforms[m_cubeState.CubieAt(i)].UpdateIdentityRotation(
+                AXIS_ROTATION_TYPES[MoveTables::Axis(m_activeMove)], MoveTables::QuarterTurns(m_activeMove)*M_PI_2);
+        }
+    }
+
+    // the cube engine moves every sub cube in the slice to its new position,
+    // the hash only changes for the pieces that moved
+    m_stateHash = ZobristHash::ApplyMove(m_cubeState, m_stateHash, m_activeMove);
+    if (m_countStateVisits){
+        m_stateVisits[m_stateHash]++;
+    }
+    m_completedMoves++;
+
+    m_rotating = false;
+    m_rotationAngle = m_previousAngle = 0.0f;
+}
+
+// with collapsing on, every waiting move adds another turn's worth of speed
+float CubeSimulation::GetSpeedMultiplier() const{
+    if (!m_collapseQueuedMoves) {
+        return 1.0f;
+    }
+    return 1.0f + m_moveQueue.Size();
+}
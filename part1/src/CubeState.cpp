@@ -0,0 +1,117 @@
+#include "CubeState.hpp"
+#include "MoveTables.hpp"
+
+#include <cstring>
+
+using MoveTables::TABLES;
+
+CubeState::CubeState(){
+    Reset();
+}
+
+void CubeState::Reset(){
+    std::memset(m_cubies, 0, sizeof(m_cubies));
+    for (int i=0; i<NUM_EDGES; i++){
+        m_cubies[EDGE_OFFSET+i] = i;
+    }
+    for (int i=0; i<NUM_CORNERS; i++){
+        m_cubies[CORNER_OFFSET+i] = i;
+    }
+    for (int i=0; i<NUM_CENTERS; i++){
+        m_cubies[CENTER_OFFSET+i] = i;
+    }
+}
+
+void CubeState::ApplyMove(Move move){
+    const MoveTables::MoveTable& table = TABLES.moves[static_cast<int>(move)];
+    uint8_t result[PACKED_SIZE] = {};
+
+    // edge flip lives in bit 4, adding wraps around at 32
+    for (int i=EDGE_OFFSET; i<EDGE_OFFSET+NUM_EDGES; i++){
+        result[i] = (m_cubies[table.perm[i]] + table.add[i]) & 0x1F;
+    }
+    // corner twist lives in bits 3-4 and wraps around at 3*8
+    for (int i=CORNER_OFFSET; i<CORNER_OFFSET+NUM_CORNERS; i++){
+        uint8_t v = m_cubies[table.perm[i]] + table.add[i];
+        result[i] = v >= 24 ? v-24 : v;
+    }
+    // center spin lives in bits 3-4 and wraps around at 4*8
+    for (int i=CENTER_OFFSET; i<CENTER_OFFSET+NUM_CENTERS; i++){
+        result[i] = (m_cubies[table.perm[i]] + table.add[i]) & 0x1F;
+    }
+
+    std::memcpy(m_cubies, result, sizeof(m_cubies));
+}
+
+bool CubeState::IsSolved() const{
+    return *this == CubeState();
+}
+
+bool CubeState::IsSolvedIgnoringCenterSpin() const{
+    CubeState solved;
+    for (int i=0; i<NUM_CENTERS; i++){
+        if (CenterPiece(i) != i){
+            return false;
+        }
+    }
+    return std::memcmp(m_cubies, solved.m_cubies, CENTER_OFFSET) == 0;
+}
+
+int CubeState::EdgePiece(int position) const{
+    return m_cubies[EDGE_OFFSET+position] & 0x0F;
+}
+
+int CubeState::EdgeOrientation(int position) const{
+    return m_cubies[EDGE_OFFSET+position] >> 4;
+}
+
+int CubeState::CornerPiece(int position) const{
+    return m_cubies[CORNER_OFFSET+position] & 0x07;
+}
+
+int CubeState::CornerOrientation(int position) const{
+    return m_cubies[CORNER_OFFSET+position] >> 3;
+}
+
+int CubeState::CenterPiece(int position) const{
+    return m_cubies[CENTER_OFFSET+position] & 0x07;
+}
+
+int CubeState::CenterOrientation(int position) const{
+    return m_cubies[CENTER_OFFSET+position] >> 3;
+}
+
+void CubeState::SetEdge(int position, int piece, int orientation){
+    m_cubies[EDGE_OFFSET+position] = piece | (orientation << 4);
+}
+
+void CubeState::SetCorner(int position, int piece, int orientation){
+    m_cubies[CORNER_OFFSET+position] = piece | (orientation << 3);
+}
+
+int CubeState::CubieAt(int slot) const{
+    int byte = TABLES.slotByte[slot];
+    // the core never moves
+    if (byte < 0){
+        return slot;
+    }
+    if (byte >= CENTER_OFFSET){
+        return TABLES.centerSlot[CenterPiece(byte-CENTER_OFFSET)];
+    }
+    if (byte >= CORNER_OFFSET){
+        return TABLES.cornerSlot[CornerPiece(byte-CORNER_OFFSET)];
+    }
+    return TABLES.edgeSlot[EdgePiece(byte-EDGE_OFFSET)];
+}
+
+const uint8_t* CubeState::Data() const{
+    return m_cubies;
+}
+
+bool CubeState::operator==(const CubeState& other) const{
+    return std::memcmp(m_cubies, other.m_cubies, sizeof(m_cubies)) == 0;
+}
+
+bool CubeState::operator!=(const CubeState& other) const{
+    return !(*this == other);
+}
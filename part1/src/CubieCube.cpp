@@ -0,0 +1,250 @@
+#include "CubieCube.hpp"
+
+#include <algorithm>
+
+namespace {
+    // rotations in the Move enum, used to bring the centers home
+    const int FIRST_ROTATION = static_cast<int>(Move::X);
+    const int NUM_ROTATION_MOVES = 9;
+
+    // cubies of every face turn
+    struct FaceMoves{
+        CubieCube moves[CubeState::NUM_FACE_MOVES];
+        FaceMoves(){
+            for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+                CubeState state;
+                state.ApplyMove(static_cast<Move>(m));
+                moves[m] = CubieCube::FromState(state);
+            }
+        }
+    };
+
+    // orientation of a corner with orientation a moved by b. Values 3..5
+    // are mirrored: a mirror turns twists the other way around
+    int AddCornerOrientation(int a, int b){
+        if (a < 3 && b < 3){
+            return (a + b) % 3;
+        }
+        if (a < 3){
+            return 3 + (a + b) % 3;
+        }
+        if (b < 3){
+            return 3 + (a - b + 3) % 3;
+        }
+        return (a - b + 3) % 3;
+    }
+
+    bool CentersHome(const CubeState& state){
+        for (int i=0; i<CubeState::NUM_CENTERS; i++){
+            if (state.CenterPiece(i) != i){
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+CubieCube CubieCube::FromState(const CubeState& state){
+    CubieCube cube;
+    for (int i=0; i<CubeState::NUM_CORNERS; i++){
+        cube.cp[i] = state.CornerPiece(i);
+        cube.co[i] = state.CornerOrientation(i);
+    }
+    for (int i=0; i<CubeState::NUM_EDGES; i++){
+        cube.ep[i] = state.EdgePiece(i);
+        cube.eo[i] = state.EdgeOrientation(i);
+    }
+    return cube;
+}
+
+CubeState CubieCube::ToState() const{
+    CubeState state;
+    for (int i=0; i<CubeState::NUM_CORNERS; i++){
+        state.SetCorner(i, cp[i], co[i]);
+    }
+    for (int i=0; i<CubeState::NUM_EDGES; i++){
+        state.SetEdge(i, ep[i], eo[i]);
+    }
+    return state;
+}
+
+CubieCube CubieCube::Solved(){
+    return FromState(CubeState());
+}
+
+const CubieCube& CubieCube::FaceMove(int move){
+    static const FaceMoves FACE_MOVES;
+    return FACE_MOVES.moves[move];
+}
+
+CubieCube CubieCube::Multiply(const CubieCube& other) const{
+    CubieCube result;
+    for (int i=0; i<CubeState::NUM_CORNERS; i++){
+        result.cp[i] = cp[other.cp[i]];
+        result.co[i] = AddCornerOrientation(co[other.cp[i]], other.co[i]);
+    }
+    for (int i=0; i<CubeState::NUM_EDGES; i++){
+        result.ep[i] = ep[other.ep[i]];
+        result.eo[i] = (eo[other.ep[i]] + other.eo[i]) % 2;
+    }
+    return result;
+}
+
+CubieCube CubieCube::Inverse() const{
+    CubieCube result;
+    for (int i=0; i<CubeState::NUM_CORNERS; i++){
+        result.cp[cp[i]] = i;
+    }
+    for (int i=0; i<CubeState::NUM_CORNERS; i++){
+        int orientation = co[result.cp[i]];
+        // a mirrored orientation undoes itself
+        result.co[i] = orientation >= 3 ? orientation : (3 - orientation) % 3;
+    }
+    for (int i=0; i<CubeState::NUM_EDGES; i++){
+        result.ep[ep[i]] = i;
+    }
+    for (int i=0; i<CubeState::NUM_EDGES; i++){
+        result.eo[i] = eo[result.ep[i]];
+    }
+    return result;
+}
+
+bool CubieCube::IsSolvable() const{
+    int twist = 0;
+    int flip = 0;
+    for (int i=0; i<CubeState::NUM_CORNERS; i++){
+        twist += co[i];
+    }
+    for (int i=0; i<CubeState::NUM_EDGES; i++){
+        flip += eo[i];
+    }
+    // corner and edge permutations have the same parity
+    int parity = 0;
+    for (int i=0; i<CubeState::NUM_CORNERS; i++){
+        for (int j=i+1; j<CubeState::NUM_CORNERS; j++){
+            parity ^= cp[j] < cp[i];
+        }
+    }
+    for (int i=0; i<CubeState::NUM_EDGES; i++){
+        for (int j=i+1; j<CubeState::NUM_EDGES; j++){
+            parity ^= ep[j] < ep[i];
+        }
+    }
+    return twist % 3 == 0 && flip % 2 == 0 && parity == 0;
+}
+
+int CubieCube::Twist() const{
+    int twist = 0;
+    for (int i=0; i<CubeState::NUM_CORNERS-1; i++){
+        twist = twist*3 + co[i];
+    }
+    return twist;
+}
+
+void CubieCube::SetTwist(int twist){
+    int sum = 0;
+    for (int i=CubeState::NUM_CORNERS-2; i>=0; i--){
+        co[i] = twist % 3;
+        sum += co[i];
+        twist /= 3;
+    }
+    // total twist is always a multiple of three
+    co[CubeState::NUM_CORNERS-1] = (3 - sum % 3) % 3;
+}
+
+int CubieCube::Flip() const{
+    int flip = 0;
+    for (int i=0; i<CubeState::NUM_EDGES-1; i++){
+        flip = flip*2 + eo[i];
+    }
+    return flip;
+}
+
+void CubieCube::SetFlip(int flip){
+    int sum = 0;
+    for (int i=CubeState::NUM_EDGES-2; i>=0; i--){
+        eo[i] = flip % 2;
+        sum += eo[i];
+        flip /= 2;
+    }
+    // total flip is always even
+    eo[CubeState::NUM_EDGES-1] = sum % 2;
+}
+
+int CubieCube::CornerPerm() const{
+    return PermIndex(cp, CubeState::NUM_CORNERS);
+}
+
+void CubieCube::SetCornerPerm(int index){
+    SetPerm(cp, CubeState::NUM_CORNERS, index, 0);
+}
+
+int CubieCube::Choose(int n, int k){
+    if (k < 0 || k > n){
+        return 0;
+    }
+    int result = 1;
+    for (int i=0; i<k; i++){
+        result = result*(n-i)/(i+1);
+    }
+    return result;
+}
+
+int CubieCube::PermIndex(const uint8_t* values, int n){
+    int index = 0;
+    for (int i=0; i<n; i++){
+        int smaller = 0;
+        for (int j=i+1; j<n; j++){
+            smaller += values[j] < values[i];
+        }
+        index = index*(n-i) + smaller;
+    }
+    return index;
+}
+
+void CubieCube::SetPerm(uint8_t* values, int n, int index, int offset){
+    int digits[CubeState::NUM_EDGES];
+    for (int i=n-1; i>=0; i--){
+        digits[i] = index % (n-i);
+        index /= (n-i);
+    }
+    uint8_t unused[CubeState::NUM_EDGES];
+    for (int i=0; i<n; i++){
+        unused[i] = i;
+    }
+    for (int i=0; i<n; i++){
+        values[i] = unused[digits[i]] + offset;
+        std::copy(unused + digits[i] + 1, unused + n - i, unused + digits[i]);
+    }
+}
+
+bool CubieCube::FindCenterRotations(const CubeState& state, std::vector<Move>& rotations){
+    rotations.clear();
+    if (CentersHome(state)){
+        return true;
+    }
+    // every single rotation before any pair, so one rotation is never
+    // written as two
+    for (int first=0; first<NUM_ROTATION_MOVES; first++){
+        CubeState once = state;
+        once.ApplyMove(static_cast<Move>(FIRST_ROTATION + first));
+        if (CentersHome(once)){
+            rotations.push_back(static_cast<Move>(FIRST_ROTATION + first));
+            return true;
+        }
+    }
+    for (int first=0; first<NUM_ROTATION_MOVES; first++){
+        CubeState once = state;
+        once.ApplyMove(static_cast<Move>(FIRST_ROTATION + first));
+        for (int second=0; second<NUM_ROTATION_MOVES; second++){
+            CubeState twice = once;
+            twice.ApplyMove(static_cast<Move>(FIRST_ROTATION + second));
+            if (CentersHome(twice)){
+                rotations.push_back(static_cast<Move>(FIRST_ROTATION + first));
+                rotations.push_back(static_cast<Move>(FIRST_ROTATION + second));
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,102 @@
+#include "Goal.hpp"
+#include "MoveParser.hpp"
+
+namespace {
+    // corners and edges of the D layer, and the middle layer edges
+    const int D_CORNERS = 0xF0;
+    const int D_EDGES = 0x0F0;
+    const int SLICE_EDGES = 0xF00;
+
+    // patterns made by a move sequence
+    struct NamedPattern{
+        const char* name;
+        const char* moves;
+    };
+    const NamedPattern PATTERNS[] = {
+        {"checkerboard", "U2 D2 F2 B2 L2 R2"},
+        {"cubeincube", "F L F U' R U F2 L2 U' L' B D' B' L2 U"},
+    };
+}
+
+Goal Goal::Solved(){
+    Goal goal;
+    goal.target = CubieCube::Solved();
+    goal.cornerMask = ALL_CORNERS;
+    goal.edgeMask = ALL_EDGES;
+    return goal;
+}
+
+Goal Goal::FromMoves(const std::vector<Move>& moves){
+    CubeState state;
+    for (Move move : moves){
+        state.ApplyMove(move);
+    }
+    // any state made by moves has centers a rotation can bring home
+    std::vector<Move> rotations;
+    CubieCube::FindCenterRotations(state, rotations);
+    for (Move rotation : rotations){
+        state.ApplyMove(rotation);
+    }
+    Goal goal = Solved();
+    goal.target = CubieCube::FromState(state);
+    return goal;
+}
+
+bool Goal::FromName(const std::string& name, Goal& goal){
+    goal = Solved();
+    if (name == "solved"){
+        return true;
+    }
+    if (name == "cross"){
+        goal.cornerMask = 0;
+        goal.edgeMask = D_EDGES;
+        return true;
+    }
+    if (name == "f2l"){
+        goal.cornerMask = D_CORNERS;
+        goal.edgeMask = D_EDGES | SLICE_EDGES;
+        return true;
+    }
+    if (name == "superflip"){
+        for (int i=0; i<CubeState::NUM_EDGES; i++){
+            goal.target.eo[i] = 1;
+        }
+        return true;
+    }
+    for (const NamedPattern& pattern : PATTERNS){
+        if (name == pattern.name){
+            std::vector<Move> moves;
+            MoveParser::ParseString(pattern.moves, moves);
+            goal = FromMoves(moves);
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<std::string>& Goal::Names(){
+    static const std::vector<std::string> names = {"solved", "cross", "f2l", "superflip", "checkerboard", "cubeincube"};
+    return names;
+}
+
+bool Goal::IsComplete() const{
+    return cornerMask == ALL_CORNERS && edgeMask == ALL_EDGES;
+}
+
+CubieCube Goal::Relative(const CubieCube& cube) const{
+    return target.Inverse().Multiply(cube);
+}
+
+bool Goal::IsReachedBy(const CubieCube& cube) const{
+    for (int i=0; i<CubeState::NUM_CORNERS; i++){
+        if ((cornerMask & (1 << i)) && (cube.cp[i] != target.cp[i] || cube.co[i] != target.co[i])){
+            return false;
+        }
+    }
+    for (int i=0; i<CubeState::NUM_EDGES; i++){
+        if ((edgeMask & (1 << i)) && (cube.ep[i] != target.ep[i] || cube.eo[i] != target.eo[i])){
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+#include "LastLayerTable.hpp"
+
+namespace {
+    const char FILE_MAGIC[8] = "CUBELLA";
+    // U corners and U edges are the first four of each
+    const int LAYER_PIECES = 4;
+    const int NUM_TWISTS = 27;
+    const int NUM_FLIPS = 8;
+    // edge orders only count by halves, the parity follows from the corners
+    const int NUM_EDGE_HALVES = 12;
+
+    // parity of the permutation with a Lehmer code, the sum of its digits
+    int Parity(int index, int n){
+        int parity = 0;
+        for (int i=n-1; i>=0; i--){
+            parity += index % (n-i);
+            index /= (n-i);
+        }
+        return parity & 1;
+    }
+}
+
+LastLayerTable::LastLayerTable():AlgorithmTable(NUM_CASES, FILE_MAGIC){
+}
+
+int LastLayerTable::Signature(const CubieCube& cube){
+    int cornerPerm = CubieCube::PermIndex(cube.cp, LAYER_PIECES);
+    int edgePerm = CubieCube::PermIndex(cube.ep, LAYER_PIECES);
+    int twist = (cube.co[0]*3 + cube.co[1])*3 + cube.co[2];
+    int flip = (cube.eo[0]*2 + cube.eo[1])*2 + cube.eo[2];
+    // the lowest bit of the edge order is its parity, which has to be the
+    // corners' parity
+    return ((cornerPerm*NUM_TWISTS + twist)*NUM_EDGE_HALVES + edgePerm/2)*NUM_FLIPS + flip;
+}
+
+CubieCube LastLayerTable::CaseCube(int signature){
+    CubieCube cube = CubieCube::Solved();
+    int flip = signature % NUM_FLIPS;
+    signature /= NUM_FLIPS;
+    int edgePerm = (signature % NUM_EDGE_HALVES)*2;
+    signature /= NUM_EDGE_HALVES;
+    int twist = signature % NUM_TWISTS;
+    int cornerPerm = signature / NUM_TWISTS;
+    if (Parity(edgePerm, LAYER_PIECES) != Parity(cornerPerm, LAYER_PIECES)){
+        edgePerm |= 1;
+    }
+    CubieCube::SetPerm(cube.cp, LAYER_PIECES, cornerPerm, 0);
+    CubieCube::SetPerm(cube.ep, LAYER_PIECES, edgePerm, 0);
+    int twistSum = 0;
+    int flipSum = 0;
+    for (int i=LAYER_PIECES-2; i>=0; i--){
+        cube.co[i] = twist % 3;
+        twistSum += twist % 3;
+        twist /= 3;
+        cube.eo[i] = flip % 2;
+        flipSum += flip % 2;
+        flip /= 2;
+    }
+    cube.co[LAYER_PIECES-1] = (3 - twistSum % 3) % 3;
+    cube.eo[LAYER_PIECES-1] = flipSum % 2;
+    return cube;
+}
@@ -0,0 +1,340 @@
+#include "MoveParser.hpp"
+#include "MoveTables.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+    // no ',' or ':' in an open group yet
+    const size_t NO_SEPARATOR = SIZE_MAX;
+    // base moves in Move enum order: U R F D L B M E S x y z Uw Rw Fw Dw Lw Bw
+    const int NUM_FACES = 6;
+    const int WIDE_OFFSET = 12;
+
+    // base move for a letter, -1 if it is not a move
+    int BaseForLetter(char c){
+        switch(c){
+            case 'U': return 0;
+            case 'R': return 1;
+            case 'F': return 2;
+            case 'D': return 3;
+            case 'L': return 4;
+            case 'B': return 5;
+            case 'M': case 'm': return 6;
+            case 'E': case 'e': return 7;
+            case 'S': case 's': return 8;
+            case 'x': case 'X': return 9;
+            case 'y': case 'Y': return 10;
+            case 'z': case 'Z': return 11;
+            // lowercase faces are wide moves
+            case 'u': return WIDE_OFFSET+0;
+            case 'r': return WIDE_OFFSET+1;
+            case 'f': return WIDE_OFFSET+2;
+            case 'd': return WIDE_OFFSET+3;
+            case 'l': return WIDE_OFFSET+4;
+            case 'b': return WIDE_OFFSET+5;
+            default: return -1;
+        }
+    }
+
+    bool IsDigit(char c){
+        return c >= '0' && c <= '9';
+    }
+
+    // number of quarter turns (0-3) for an amount and prime
+    int PowerOf(int amount, bool prime){
+        int power = (amount < 0 ? 1 : amount) % 4;
+        return prime ? (4 - power) % 4 : power;
+    }
+
+    const char* MOVE_NAMES[CubeState::NUM_MOVES] = {
+        "U", "U2", "U'", "R", "R2", "R'", "F", "F2", "F'",
+        "D", "D2", "D'", "L", "L2", "L'", "B", "B2", "B'",
+        "M", "M2", "M'", "E", "E2", "E'", "S", "S2", "S'",
+        "x", "x2", "x'", "y", "y2", "y'", "z", "z2", "z'",
+        "Uw", "Uw2", "Uw'", "Rw", "Rw2", "Rw'", "Fw", "Fw2", "Fw'",
+        "Dw", "Dw2", "Dw'", "Lw", "Lw2", "Lw'", "Bw", "Bw2", "Bw'"
+    };
+}
+
+MoveParser::MoveParser(Sink& sink):m_sink(sink){
+    m_base = -1;
+    m_wide = false;
+    m_amount = -1;
+    m_prime = false;
+    m_groupSuffix = false;
+    m_groupAmount = -1;
+    m_groupPrime = false;
+    m_slash = false;
+    m_comment = false;
+    m_sequenceStarted = false;
+    m_line = 1;
+    m_column = 0;
+    m_failed = false;
+}
+
+bool MoveParser::Feed(const char* text, size_t length){
+    for (size_t i=0; i<length && !m_failed; i++){
+        if (text[i] == '\n'){
+            m_line++;
+            m_column = 0;
+        } else {
+            m_column++;
+        }
+        ProcessChar(text[i]);
+    }
+    return !m_failed;
+}
+
+bool MoveParser::Finish(){
+    // a missing final newline still ends the last line
+    if (!m_failed){
+        ProcessChar('\n');
+    }
+    if (!m_failed && !m_groupStarts.empty()){
+        Fail("unclosed group at end of input");
+    }
+    return !m_failed;
+}
+
+bool MoveParser::ParseStream(std::istream& in){
+    // fixed buffer, the parser keeps its own state between chunks
+    char buffer[1 << 16];
+    while (!m_failed && in){
+        in.read(buffer, sizeof(buffer));
+        Feed(buffer, static_cast<size_t>(in.gcount()));
+    }
+    return Finish();
+}
+
+const std::string& MoveParser::GetError() const{
+    return m_error;
+}
+
+bool MoveParser::ProcessChar(char c){
+    // comments run to the end of the line
+    if (m_comment){
+        if (c != '\n'){
+            return true;
+        }
+        m_comment = false;
+    }
+    if (m_slash){
+        m_slash = false;
+        if (c != '/'){
+            return Fail("expected // to start a comment");
+        }
+        FlushMove();
+        m_comment = true;
+        return true;
+    }
+
+    // modifiers of the pending move: w, amount and prime
+    if (m_base >= 0){
+        if (c == 'w' && !m_wide && m_base < NUM_FACES && m_amount < 0 && !m_prime){
+            m_wide = true;
+            return true;
+        }
+        if (IsDigit(c) && m_amount < 100){
+            m_amount = (m_amount < 0 ? 0 : m_amount*10) + (c - '0');
+            return true;
+        }
+        if (c == '\'' && !m_prime){
+            m_prime = true;
+            return true;
+        }
+        FlushMove();
+    }
+
+    // repeat count and prime after a closing bracket
+    if (m_groupSuffix){
+        if (IsDigit(c) && m_groupAmount < 100000){
+            m_groupAmount = (m_groupAmount < 0 ? 0 : m_groupAmount*10) + (c - '0');
+            return true;
+        }
+        if (c == '\'' && !m_groupPrime){
+            m_groupPrime = true;
+            return true;
+        }
+        if (!FlushGroup()){
+            return false;
+        }
+    }
+
+    switch(c){
+        case ' ': case '\t': case '\r': case '.':
+            return true;
+        case '\n':
+            // lines are sequences, groups may span lines
+            if (m_groupStarts.empty() && m_sequenceStarted){
+                m_sequenceStarted = false;
+                m_sink.OnSequenceEnd();
+            }
+            return true;
+        case '/':
+            m_slash = true;
+            return true;
+        case '(': case '[':
+            m_groupStarts.push_back(m_groupMoves.size());
+            m_groupBrackets.push_back(c);
+            m_groupSeparators.push_back(NO_SEPARATOR);
+            m_groupSeparatorChars.push_back(' ');
+            m_sequenceStarted = true;
+            return true;
+        case ',': case ':':
+            // splits [A, B] or [A: B] in two
+            if (m_groupStarts.empty() || m_groupBrackets.back() != '['){
+                return Fail(c == ',' ? "',' outside of a commutator [A, B]" : "':' outside of a conjugate [A: B]");
+            }
+            if (m_groupSeparators.back() != NO_SEPARATOR){
+                return Fail("a commutator or conjugate has only two parts");
+            }
+            m_groupSeparators.back() = m_groupMoves.size();
+            m_groupSeparatorChars.back() = c;
+            return true;
+        case ')': case ']':
+            if (m_groupStarts.empty()){
+                return Fail("closing bracket without an open group");
+            }
+            if (m_groupBrackets.back() != (c == ')' ? '(' : '[')){
+                return Fail("closing bracket does not match the open one");
+            }
+            m_groupSuffix = true;
+            m_groupAmount = -1;
+            m_groupPrime = false;
+            return true;
+        default:
+            break;
+    }
+
+    m_base = BaseForLetter(c);
+    if (m_base < 0){
+        return Fail("unexpected character");
+    }
+    m_wide = false;
+    m_amount = -1;
+    m_prime = false;
+    m_sequenceStarted = true;
+    return true;
+}
+
+void MoveParser::FlushMove(){
+    if (m_base < 0){
+        return;
+    }
+    int base = m_wide ? m_base + WIDE_OFFSET : m_base;
+    int power = PowerOf(m_amount, m_prime);
+    m_base = -1;
+    // a multiple of four turns does nothing
+    if (power != 0){
+        Emit(MoveTables::MakeMove(base, power));
+    }
+}
+
+bool MoveParser::FlushGroup(){
+    m_groupSuffix = false;
+    size_t start = m_groupStarts.back();
+    size_t separator = m_groupSeparators.back();
+    char separatorChar = m_groupSeparatorChars.back();
+    m_groupStarts.pop_back();
+    m_groupBrackets.pop_back();
+    m_groupSeparators.pop_back();
+    m_groupSeparatorChars.pop_back();
+    size_t repeats = m_groupAmount < 0 ? 1 : m_groupAmount;
+
+    // [A, B] is A B A' B' and [A: B] is A B A', the inverses are appended
+    // in place after A B
+    if (separator != NO_SEPARATOR){
+        size_t middle = m_groupMoves.size();
+        size_t expanded = middle + (separatorChar == ',' ? middle - start : separator - start);
+        if (expanded > MAX_GROUP_MOVES){
+            return Fail("group expands to too many moves");
+        }
+        m_groupMoves.reserve(expanded);
+        for (size_t i=separator; i>start; i--){
+            m_groupMoves.push_back(MoveTables::Inverse(m_groupMoves[i-1]));
+        }
+        if (separatorChar == ','){
+            for (size_t i=middle; i>separator; i--){
+                m_groupMoves.push_back(MoveTables::Inverse(m_groupMoves[i-1]));
+            }
+        }
+    }
+    size_t end = m_groupMoves.size();
+
+    // a primed group is the inverse sequence
+    if (m_groupPrime){
+        std::reverse(m_groupMoves.begin() + start, m_groupMoves.end());
+        for (size_t i=start; i<end; i++){
+            m_groupMoves[i] = MoveTables::Inverse(m_groupMoves[i]);
+        }
+    }
+
+    // outermost group: stream the repeats straight to the sink
+    if (m_groupStarts.empty()){
+        for (size_t r=0; r<repeats; r++){
+            for (size_t i=start; i<end; i++){
+                m_sink.OnMove(m_groupMoves[i]);
+            }
+        }
+        m_groupMoves.clear();
+        return true;
+    }
+
+    // nested group: repeat in place inside the enclosing group
+    size_t length = end - start;
+    if (start + length*repeats > MAX_GROUP_MOVES){
+        return Fail("group expands to too many moves");
+    }
+    m_groupMoves.resize(start + length*repeats);
+    for (size_t r=1; r<repeats; r++){
+        std::copy(m_groupMoves.begin() + start, m_groupMoves.begin() + end,
+                  m_groupMoves.begin() + start + r*length);
+    }
+    return true;
+}
+
+void MoveParser::Emit(Move move){
+    if (m_groupStarts.empty()){
+        m_sink.OnMove(move);
+    } else {
+        m_groupMoves.push_back(move);
+    }
+}
+
+bool MoveParser::Fail(const char* message){
+    if (!m_failed){
+        m_failed = true;
+        m_error = "line " + std::to_string(m_line) + ", column " + std::to_string(m_column) + ": " + message;
+    }
+    return false;
+}
+
+bool MoveParser::ParseString(const std::string& text, std::vector<Move>& moves, std::string* error){
+    VectorSink sink(moves);
+    MoveParser parser(sink);
+    bool ok = parser.Feed(text.data(), text.size()) && parser.Finish();
+    if (!ok && error != nullptr){
+        *error = parser.GetError();
+    }
+    return ok;
+}
+
+const char* MoveParser::Name(Move move){
+    return MOVE_NAMES[static_cast<int>(move)];
+}
+
+std::string MoveParser::ToString(const Move* moves, size_t count){
+    std::string result;
+    for (size_t i=0; i<count; i++){
+        if (i > 0){
+            result += ' ';
+        }
+        result += Name(moves[i]);
+    }
+    return result;
+}
+
+std::string MoveParser::ToString(const std::vector<Move>& moves){
+    return ToString(moves.data(), moves.size());
+}
@@ -0,0 +1,45 @@
+#include "MoveQueue.hpp"
+
+MoveQueue::MoveQueue(){
+    Clear();
+}
+
+bool MoveQueue::Push(Move move){
+    if (Full()){
+        return false;
+    }
+    m_moves[(m_head + m_size) % CAPACITY] = move;
+    m_size++;
+    return true;
+}
+
+bool MoveQueue::Pop(Move& move){
+    if (Empty()){
+        return false;
+    }
+    move = m_moves[m_head];
+    m_head = (m_head + 1) % CAPACITY;
+    m_size--;
+    return true;
+}
+
+Move MoveQueue::Peek(int index) const{
+    return m_moves[(m_head + index) % CAPACITY];
+}
+
+void MoveQueue::Clear(){
+    m_head = 0;
+    m_size = 0;
+}
+
+int MoveQueue::Size() const{
+    return m_size;
+}
+
+bool MoveQueue::Empty() const{
+    return m_size == 0;
+}
+
+bool MoveQueue::Full() const{
+    return m_size == CAPACITY;
+}
@@ -0,0 +1,216 @@
+#include "MoveSimplifier.hpp"
+#include "MoveTables.hpp"
+
+using MoveTables::BASE_MOVES;
+using MoveTables::NUM_BASE_MOVES;
+
+namespace {
+    const int NUM_METRICS = 3;
+    // every combination of quarter turns for the three layers of an axis
+    const int NUM_LAYER_STATES = 64;
+    // a run never needs more than one move of each kind
+    const int MAX_RUN_MOVES = 6;
+    // layer masks, bit (coordinate+1) is set for every layer that turns
+    const int LOW_FACE = 1, SLICE = 2, HIGH_FACE = 4, LOW_WIDE = 3, HIGH_WIDE = 6, ROTATION = 7;
+
+    // turns a base move with a power (1, 2 or 3) takes in a metric
+    constexpr int MoveCost(int base, int power, MoveSimplifier::Metric metric){
+        bool slice = BASE_MOVES[base].layers == SLICE;
+        int cost = (metric == MoveSimplifier::Metric::QTM && power == 2) ? 2 : 1;
+        // a slice takes an outer and a wide turn unless slices are counted
+        // on their own
+        return (slice && metric != MoveSimplifier::Metric::STM) ? cost*2 : cost;
+    }
+
+    // cheapest moves for the layer turns of one axis
+    struct Representation{
+        uint8_t count;
+        uint8_t cost;
+        Move moves[MAX_RUN_MOVES];
+    };
+
+    struct Tables{
+        Representation runs[NUM_METRICS][3][NUM_LAYER_STATES];
+    };
+
+    constexpr int LayerIndex(int low, int mid, int high){
+        return low*16 + mid*4 + high;
+    }
+
+    constexpr Representation BuildRepresentation(int metricIndex, int axis, int low, int mid, int high){
+        MoveSimplifier::Metric metric = static_cast<MoveSimplifier::Metric>(metricIndex);
+        // base move for every layer mask of this axis
+        int baseFor[8] = {-1, -1, -1, -1, -1, -1, -1, -1};
+        for (int b=0; b<NUM_BASE_MOVES; b++){
+            if (BASE_MOVES[b].axis == axis){
+                baseFor[BASE_MOVES[b].layers] = b;
+            }
+        }
+
+        Representation best{};
+        int bestCount = 0;
+        int bestOthers = 0;
+        bool found = false;
+        // pick the wide and rotation turns, the faces and slice make up the rest
+        for (int lowWide=0; lowWide<4; lowWide++){
+            for (int highWide=0; highWide<4; highWide++){
+                for (int rotation=0; rotation<4; rotation++){
+                    int amounts[8] = {};
+                    amounts[LOW_WIDE] = lowWide;
+                    amounts[HIGH_WIDE] = highWide;
+                    amounts[ROTATION] = rotation;
+                    amounts[LOW_FACE] = ((low - lowWide - rotation) % 4 + 4) % 4;
+                    amounts[SLICE] = ((mid - lowWide - highWide - rotation) % 4 + 4) % 4;
+                    amounts[HIGH_FACE] = ((high - highWide - rotation) % 4 + 4) % 4;
+                    // only the slice turn metric writes slices
+                    if (amounts[SLICE] != 0 && metric != MoveSimplifier::Metric::STM){
+                        continue;
+                    }
+
+                    Representation candidate{};
+                    int others = 0;
+                    // write moves in Move enum order, so faces come first
+                    for (int b=0; b<NUM_BASE_MOVES; b++){
+                        if (BASE_MOVES[b].axis != axis){
+                            continue;
+                        }
+                        int mask = BASE_MOVES[b].layers;
+                        if (baseFor[mask] != b || amounts[mask] == 0){
+                            continue;
+                        }
+                        // counter-clockwise quarter turns to a power of the move
+                        int power = ((amounts[mask]*BASE_MOVES[b].turns) % 4 + 4) % 4;
+                        candidate.moves[candidate.count++] = MoveTables::MakeMove(b, power);
+                        candidate.cost += MoveCost(b, power, metric);
+                        others += (mask != LOW_FACE && mask != HIGH_FACE);
+                    }
+                    // fewest turns, then fewest moves, then fewest non face moves
+                    bool better = !found
+                        || candidate.cost < best.cost
+                        || (candidate.cost == best.cost && candidate.count < bestCount)
+                        || (candidate.cost == best.cost && candidate.count == bestCount && others < bestOthers);
+                    if (better){
+                        best = candidate;
+                        bestCount = candidate.count;
+                        bestOthers = others;
+                        found = true;
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    constexpr Tables BuildTables(){
+        Tables tables{};
+        for (int metric=0; metric<NUM_METRICS; metric++){
+            for (int axis=0; axis<3; axis++){
+                for (int i=0; i<NUM_LAYER_STATES; i++){
+                    tables.runs[metric][axis][i] = BuildRepresentation(metric, axis, i/16, (i/4)%4, i%4);
+                }
+            }
+        }
+        return tables;
+    }
+
+    constexpr Tables TABLES = BuildTables();
+
+    const Representation& Lookup(MoveSimplifier::Metric metric, int axis, const uint8_t (&layers)[3]){
+        return TABLES.runs[static_cast<int>(metric)][axis][LayerIndex(layers[0], layers[1], layers[2])];
+    }
+}
+
+MoveSimplifier::MoveSimplifier(Metric metric):m_metric(metric){
+}
+
+void MoveSimplifier::Push(Move move){
+    const MoveTables::MoveDefinition& definition = BASE_MOVES[MoveTables::BaseMove(move)];
+    int turns = ((definition.turns*MoveTables::Power(move)) % 4 + 4) % 4;
+
+    // a new axis starts a new run
+    if (m_runs.empty() || m_runs.back().axis != definition.axis){
+        Run run{};
+        run.axis = definition.axis;
+        m_runs.push_back(run);
+    }
+    // same axis moves commute, add the turns of every layer
+    Run& run = m_runs.back();
+    for (int layer=0; layer<3; layer++){
+        if (definition.layers & (1 << layer)){
+            run.layers[layer] = (run.layers[layer] + turns) % 4;
+        }
+    }
+    // a run that cancels out lets the runs around it merge
+    if (run.layers[0] == 0 && run.layers[1] == 0 && run.layers[2] == 0){
+        m_runs.pop_back();
+    }
+}
+
+void MoveSimplifier::Push(const Move* moves, size_t count){
+    for (size_t i=0; i<count; i++){
+        Push(moves[i]);
+    }
+}
+
+void MoveSimplifier::Clear(){
+    m_runs.clear();
+}
+
+void MoveSimplifier::Write(std::vector<Move>& moves) const{
+    for (const Run& run : m_runs){
+        const Representation& representation = Lookup(m_metric, run.axis, run.layers);
+        moves.insert(moves.end(), representation.moves, representation.moves + representation.count);
+    }
+}
+
+int MoveSimplifier::Cost() const{
+    int cost = 0;
+    for (const Run& run : m_runs){
+        cost += Lookup(m_metric, run.axis, run.layers).cost;
+    }
+    return cost;
+}
+
+void MoveSimplifier::Simplify(std::vector<Move>& moves, Metric metric){
+    MoveSimplifier simplifier(metric);
+    simplifier.Push(moves.data(), moves.size());
+    moves.clear();
+    simplifier.Write(moves);
+}
+
+int MoveSimplifier::Cost(const Move* moves, size_t count, Metric metric){
+    int cost = 0;
+    for (size_t i=0; i<count; i++){
+        cost += MoveCost(MoveTables::BaseMove(moves[i]), MoveTables::Power(moves[i]), metric);
+    }
+    return cost;
+}
+
+int MoveSimplifier::Cost(const std::vector<Move>& moves, Metric metric){
+    return Cost(moves.data(), moves.size(), metric);
+}
+
+bool MoveSimplifier::ParseMetric(const std::string& name, Metric& metric){
+    if (name == "htm" || name == "HTM"){
+        metric = Metric::HTM;
+    } else if (name == "qtm" || name == "QTM"){
+        metric = Metric::QTM;
+    } else if (name == "stm" || name == "STM"){
+        metric = Metric::STM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* MoveSimplifier::Name(Metric metric){
+    switch(metric){
+        case Metric::HTM:
+            return "htm";
+        case Metric::QTM:
+            return "qtm";
+        case Metric::STM:
+        default:
+            return "stm";
+    }
+}
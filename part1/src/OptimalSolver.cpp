@@ -0,0 +1,727 @@
+#include "OptimalSolver.hpp"
+#include "CubieCube.hpp"
+#include "MoveTables.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace {
+    const int NUM_TWISTS = 2187;
+    const int NUM_CORNER_PERMS = 40320;
+    const int NUM_FLIP_PATTERNS = 1 << OptimalSolver::PATTERN_EDGES;
+
+    // rank of the positions of six different edges among twelve, 0..12!/6!-1
+    uint32_t PositionRank(const uint8_t* positions){
+        uint32_t rank = 0;
+        uint32_t used = 0;
+        for (int i=0; i<OptimalSolver::PATTERN_EDGES; i++){
+            int position = positions[i];
+            int free = position - __builtin_popcount(used & ((1u << position) - 1));
+            rank = rank*(CubeState::NUM_EDGES - i) + free;
+            used |= 1u << position;
+        }
+        return rank;
+    }
+
+    void SetPositionRank(uint8_t* positions, uint32_t rank){
+        int digits[OptimalSolver::PATTERN_EDGES];
+        for (int i=OptimalSolver::PATTERN_EDGES-1; i>=0; i--){
+            digits[i] = rank % (CubeState::NUM_EDGES - i);
+            rank /= (CubeState::NUM_EDGES - i);
+        }
+        uint32_t used = 0;
+        for (int i=0; i<OptimalSolver::PATTERN_EDGES; i++){
+            // the digits[i]-th position not used yet
+            int position = 0;
+            for (int free=digits[i]; ; position++){
+                if (!(used & (1u << position)) && free-- == 0){
+                    break;
+                }
+            }
+            positions[i] = position;
+            used |= 1u << position;
+        }
+    }
+
+    // pattern index of six edges given as position * 2 + flip
+    uint64_t EdgeIndex(const uint8_t* edges){
+        uint8_t positions[OptimalSolver::PATTERN_EDGES];
+        uint32_t flips = 0;
+        for (int i=0; i<OptimalSolver::PATTERN_EDGES; i++){
+            positions[i] = edges[i] >> 1;
+            flips = flips*2 + (edges[i] & 1);
+        }
+        return uint64_t(PositionRank(positions))*NUM_FLIP_PATTERNS + flips;
+    }
+
+    void SetEdgeIndex(uint8_t* edges, uint64_t index){
+        uint8_t positions[OptimalSolver::PATTERN_EDGES];
+        SetPositionRank(positions, index / NUM_FLIP_PATTERNS);
+        uint32_t flips = index % NUM_FLIP_PATTERNS;
+        for (int i=OptimalSolver::PATTERN_EDGES-1; i>=0; i--){
+            edges[i] = positions[i]*2 + (flips & 1);
+            flips >>= 1;
+        }
+    }
+
+    // Distance of every piece from home, by breadth first search from its
+    // home over position * orientations + orientation, the states of one
+    // piece in a move table like m_edgeMove. Home is piece * orientations.
+    template<size_t STATES, size_t PIECES>
+    void PieceDistances(const uint8_t (&move)[STATES][CubeState::NUM_FACE_MOVES], uint8_t (&distance)[PIECES][STATES]){
+        const int orientations = STATES/PIECES;
+        for (size_t piece=0; piece<PIECES; piece++){
+            std::fill(distance[piece], distance[piece] + STATES, 0xFF);
+            distance[piece][piece*orientations] = 0;
+            std::deque<int> queue(1, piece*orientations);
+            while (!queue.empty()){
+                int state = queue.front();
+                queue.pop_front();
+                for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+                    int next = move[state][m];
+                    if (distance[piece][next] == 0xFF){
+                        distance[piece][next] = distance[piece][state] + 1;
+                        queue.push_back(next);
+                    }
+                }
+            }
+        }
+    }
+
+    // Task numbers dealt out to one queue per worker. A worker takes its
+    // own lowest numbered task first, and when it has none left steals
+    // the highest numbered one from another worker.
+    class TaskQueues{
+    public:
+        explicit TaskQueues(int workers):m_queues(workers){
+        }
+
+        // Deal tasks 0..tasks-1 for the next iteration, while no worker
+        // is taking any
+        void Deal(int tasks){
+            int workers = m_queues.size();
+            for (int task=0; task<tasks; task++){
+                m_queues[task % workers].tasks.push_back(task);
+            }
+        }
+
+        // Next task for a worker, false once every queue is empty
+        bool Next(int worker, int& task){
+            int workers = m_queues.size();
+            for (int i=0; i<workers; i++){
+                Queue& queue = m_queues[(worker + i) % workers];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (queue.tasks.empty()){
+                    continue;
+                }
+                if (i == 0){
+                    task = queue.tasks.front();
+                    queue.tasks.pop_front();
+                } else {
+                    task = queue.tasks.back();
+                    queue.tasks.pop_back();
+                }
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        struct Queue{
+            std::mutex mutex;
+            std::deque<int> tasks;
+        };
+        std::vector<Queue> m_queues;
+    };
+}
+
+struct OptimalSolver::Search{
+    int moves[MAX_LENGTH];
+    Statistics statistics;
+    // in a parallel search: the task being searched, and the lowest
+    // numbered task solved by any thread so far, which makes searches
+    // of higher numbered tasks give up
+    int task = 0;
+    const std::atomic<int>* firstSolvedTask = nullptr;
+};
+
+struct OptimalSolver::Task{
+    Node node;
+    int estimate;
+    int moves[SPLIT_DEPTH];
+};
+
+// The workers are started by the first parallel iteration and wait on
+// start between iterations, the thread calling Run is worker 0.
+struct OptimalSolver::Pool{
+    Pool(const OptimalSolver& solver, int threads)
+        :solver(solver), threads(threads), queues(threads), searches(threads),
+         solvedTask(threads), solvedMoves(threads){
+        for (struct Search& search : searches){
+            search.firstSolvedTask = &firstSolvedTask;
+        }
+    }
+
+    ~Pool(){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        start.notify_all();
+        for (std::thread& worker : workers){
+            worker.join();
+        }
+    }
+
+    // Search every task within the bound, once Run returns the results
+    // are in firstSolvedTask, solvedTask and solvedMoves
+    void Run(const std::vector<Task>& iterationTasks, int iterationBound){
+        tasks = &iterationTasks;
+        bound = iterationBound;
+        // tasks are numbered in the order Search would get to them, so the
+        // lowest numbered task with a solution has the one Search would find
+        firstSolvedTask.store(INT_MAX);
+        std::fill(solvedTask.begin(), solvedTask.end(), INT_MAX);
+        for (struct Search& search : searches){
+            search.statistics.nodes = 0;
+        }
+        queues.Deal(iterationTasks.size());
+        while (static_cast<int>(workers.size()) < threads-1){
+            workers.emplace_back(&Pool::Wait, this, static_cast<int>(workers.size()) + 1);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            iteration++;
+            busy = threads-1;
+        }
+        start.notify_all();
+        Work(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]{ return busy == 0; });
+    }
+
+    // a worker thread, one Work per iteration until the pool is destroyed
+    void Wait(int worker){
+        int seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true){
+            start.wait(lock, [&]{ return stop || iteration != seen; });
+            if (stop){
+                return;
+            }
+            seen = iteration;
+            lock.unlock();
+            Work(worker);
+            lock.lock();
+            if (--busy == 0){
+                done.notify_one();
+            }
+        }
+    }
+
+    void Work(int worker){
+        struct Search& local = searches[worker];
+        int task;
+        while (queues.Next(worker, task)){
+            if (firstSolvedTask.load(std::memory_order_relaxed) < task){
+                continue;
+            }
+            const Task& current = (*tasks)[task];
+            local.task = task;
+            std::copy(current.moves, current.moves + SPLIT_DEPTH, local.moves);
+            if (!solver.Search(local, current.node, SPLIT_DEPTH, bound, current.estimate)){
+                continue;
+            }
+            int first = firstSolvedTask.load();
+            while (task < first && !firstSolvedTask.compare_exchange_weak(first, task)){
+            }
+            if (task < solvedTask[worker]){
+                solvedTask[worker] = task;
+                solvedMoves[worker].assign(local.moves, local.moves + bound);
+            }
+        }
+    }
+
+    const OptimalSolver& solver;
+    const int threads;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    // start wakes the workers for an iteration, done wakes Run once
+    // every one of them has finished it
+    std::condition_variable start;
+    std::condition_variable done;
+    int iteration = 0;
+    int busy = 0;
+    bool stop = false;
+
+    // the current iteration
+    const std::vector<Task>* tasks = nullptr;
+    int bound = 0;
+    TaskQueues queues;
+    std::atomic<int> firstSolvedTask{INT_MAX};
+    std::vector<struct Search> searches;
+    // lowest numbered task each worker solved, and its moves
+    std::vector<int> solvedTask;
+    std::vector<std::vector<int>> solvedMoves;
+};
+
+double OptimalSolver::Statistics::NodesPerSecond() const{
+    return seconds > 0.0 ? nodes/seconds : 0.0;
+}
+
+OptimalSolver::OptimalSolver(const std::string& tableDirectory, int threads){
+    m_cornerPermMove.resize(NUM_CORNER_PERMS*CubeState::NUM_FACE_MOVES);
+    for (int i=0; i<NUM_CORNER_PERMS; i++){
+        CubieCube cube = CubieCube::Solved();
+        cube.SetCornerPerm(i);
+        for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+            m_cornerPermMove[i*CubeState::NUM_FACE_MOVES + m] = cube.Multiply(CubieCube::FaceMove(m)).CornerPerm();
+        }
+    }
+    m_twistMove.resize(NUM_TWISTS*CubeState::NUM_FACE_MOVES);
+    for (int i=0; i<NUM_TWISTS; i++){
+        CubieCube cube = CubieCube::Solved();
+        cube.SetTwist(i);
+        for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+            m_twistMove[i*CubeState::NUM_FACE_MOVES + m] = cube.Multiply(CubieCube::FaceMove(m)).Twist();
+        }
+    }
+    // the face move puts the edge at position ep[to] into position to
+    for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+        const CubieCube& move = CubieCube::FaceMove(m);
+        for (int to=0; to<CubeState::NUM_EDGES; to++){
+            int from = move.ep[to];
+            for (int flip=0; flip<2; flip++){
+                m_edgeMove[from*2 + flip][m] = to*2 + (flip ^ move.eo[to]);
+            }
+        }
+        for (int to=0; to<CubeState::NUM_CORNERS; to++){
+            int from = move.cp[to];
+            for (int twist=0; twist<3; twist++){
+                m_cornerMove[from*3 + twist][m] = to*3 + (twist + move.co[to]) % 3;
+            }
+        }
+    }
+    // every face turn has an inverse, so the distance home is the
+    // distance from home
+    PieceDistances(m_cornerMove, m_cornerDistance);
+    PieceDistances(m_edgeMove, m_edgeDistance);
+
+    m_cornerClass.resize(NUM_CORNER_PERMS);
+    m_cornerClassSymmetry.resize(NUM_CORNER_PERMS);
+    for (int i=0; i<NUM_CORNER_PERMS; i++){
+        m_cornerClass[i] = Symmetry::CornerClass(i);
+        m_cornerClassSymmetry[i] = Symmetry::CornerClassSymmetry(i);
+    }
+    m_twistConjugate.resize(NUM_TWISTS*Symmetry::NUM_UD_SYMMETRIES);
+    for (int i=0; i<NUM_TWISTS; i++){
+        for (int s=0; s<Symmetry::NUM_UD_SYMMETRIES; s++){
+            m_twistConjugate[i*Symmetry::NUM_UD_SYMMETRIES + s] = Symmetry::ConjugateTwist(i, s);
+        }
+    }
+
+    m_tablesLoaded = 0;
+    if (!tableDirectory.empty()){
+        for (int table=0; table<NUM_TABLES; table++){
+            PatternDatabase& database = table == 0 ? m_corners : m_edges[table-1];
+            if (database.Load(TablePath(tableDirectory, table), TableName(table), TableSize(table))){
+                m_tablesLoaded++;
+            }
+        }
+    }
+
+    if (!m_corners.IsMapped()){
+        m_corners.Reset(NUM_CORNER_STATES);
+        // the solved corners are class 0, twist 0
+        m_corners.Generate(0, [this](uint64_t index, uint64_t* out){
+            int cornerPerm = Symmetry::CornerRepresentative(index / NUM_TWISTS);
+            int twist = index % NUM_TWISTS;
+            int count = 0;
+            for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+                uint64_t next = CornerIndex(m_cornerPermMove[cornerPerm*CubeState::NUM_FACE_MOVES + m],
+                                            m_twistMove[twist*CubeState::NUM_FACE_MOVES + m]);
+                out[count++] = next;
+                // a representative with symmetries of its own has one
+                // entry per twist those make of the same state
+                int cornerClass = next / NUM_TWISTS;
+                int stabilizer = Symmetry::CornerClassStabilizer(cornerClass);
+                for (int s=1; s<Symmetry::NUM_UD_SYMMETRIES; s++){
+                    if (stabilizer & (1 << s)){
+                        out[count++] = uint64_t(cornerClass)*NUM_TWISTS
+                                     + m_twistConjugate[(next % NUM_TWISTS)*Symmetry::NUM_UD_SYMMETRIES + s];
+                    }
+                }
+            }
+            return count;
+        }, threads);
+    }
+
+    for (int pattern=0; pattern<2; pattern++){
+        if (m_edges[pattern].IsMapped()){
+            continue;
+        }
+        // solved: edge piece k sits at position k, unflipped
+        uint8_t solved[PATTERN_EDGES];
+        for (int i=0; i<PATTERN_EDGES; i++){
+            solved[i] = (pattern*PATTERN_EDGES + i)*2;
+        }
+        m_edges[pattern].Reset(NUM_EDGE_STATES);
+        m_edges[pattern].Generate(EdgeIndex(solved), [this](uint64_t index, uint64_t* out){
+            uint8_t edges[PATTERN_EDGES];
+            uint8_t moved[PATTERN_EDGES];
+            SetEdgeIndex(edges, index);
+            for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+                for (int i=0; i<PATTERN_EDGES; i++){
+                    moved[i] = m_edgeMove[edges[i]][m];
+                }
+                out[m] = EdgeIndex(moved);
+            }
+            return CubeState::NUM_FACE_MOVES;
+        }, threads);
+    }
+}
+
+bool OptimalSolver::Solve(const CubeState& state, std::vector<Move>& solution,
+                          Statistics* statistics, int maxLength, int threads) const{
+    solution.clear();
+    std::vector<Move> rotations;
+    if (!CubieCube::FindCenterRotations(state, rotations)){
+        return false;
+    }
+    CubeState rotated = state;
+    for (Move rotation : rotations){
+        rotated.ApplyMove(rotation);
+    }
+    CubieCube cube = CubieCube::FromState(rotated);
+    if (!cube.IsSolvable()){
+        return false;
+    }
+    return SolveCubies(cube, rotations, solution, statistics, maxLength, threads);
+}
+
+bool OptimalSolver::Solve(const CubeState& state, const Goal& goal, std::vector<Move>& solution,
+                          Statistics* statistics, int maxLength, int threads) const{
+    solution.clear();
+    std::vector<Move> rotations;
+    if (!CubieCube::FindCenterRotations(state, rotations)){
+        return false;
+    }
+    CubeState rotated = state;
+    for (Move rotation : rotations){
+        rotated.ApplyMove(rotation);
+    }
+    // targets are real states, so this only fails if state is not
+    CubieCube cube = goal.Relative(CubieCube::FromState(rotated));
+    if (!cube.IsSolvable()){
+        return false;
+    }
+    if (goal.IsComplete()){
+        return SolveCubies(cube, rotations, solution, statistics, maxLength, threads);
+    }
+
+    struct Search search;
+    GoalNode root;
+    root.node = MakeNode(cube);
+    for (int position=0; position<CubeState::NUM_CORNERS; position++){
+        root.corners[cube.cp[position]] = position*3 + cube.co[position];
+    }
+    auto start = std::chrono::steady_clock::now();
+    bool found = false;
+    maxLength = std::min(maxLength, MAX_LENGTH);
+    int rootEstimate = GoalEstimate(root, goal.cornerMask, goal.edgeMask);
+    for (int bound=rootEstimate; bound<=maxLength && !found; bound++){
+        search.statistics.nodesPerIteration.resize(bound+1, 0);
+        long long before = search.statistics.nodes;
+        found = SearchGoal(search, root, goal.cornerMask, goal.edgeMask, 0, bound, rootEstimate);
+        search.statistics.nodesPerIteration[bound] = search.statistics.nodes - before;
+        if (found){
+            solution = rotations;
+            for (int i=0; i<bound; i++){
+                solution.push_back(static_cast<Move>(search.moves[i]));
+            }
+        }
+    }
+    search.statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (statistics != nullptr){
+        *statistics = search.statistics;
+    }
+    return found;
+}
+
+bool OptimalSolver::SolveCubies(const CubieCube& cube, const std::vector<Move>& rotations, std::vector<Move>& solution,
+                                Statistics* statistics, int maxLength, int threads) const{
+    struct Search search;
+    Node root = MakeNode(cube);
+    auto start = std::chrono::steady_clock::now();
+    bool found = false;
+    maxLength = std::min(maxLength, MAX_LENGTH);
+    if (threads <= 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // the workers stay up from the first deep iteration to the end of the solve
+    Pool pool(*this, threads);
+    // deepen one face turn at a time, the first solution found is optimal
+    int rootEstimate = Estimate(root);
+    for (int bound=rootEstimate; bound<=maxLength && !found; bound++){
+        search.statistics.nodesPerIteration.resize(bound+1, 0);
+        long long before = search.statistics.nodes;
+        // shallow iterations are over before threads would even start
+        if (threads > 1 && bound > SPLIT_DEPTH){
+            found = SearchParallel(search, pool, root, bound, rootEstimate);
+        } else {
+            found = Search(search, root, 0, bound, rootEstimate);
+        }
+        search.statistics.nodesPerIteration[bound] = search.statistics.nodes - before;
+        if (found){
+            solution = rotations;
+            for (int i=0; i<bound; i++){
+                solution.push_back(static_cast<Move>(search.moves[i]));
+            }
+        }
+    }
+    search.statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (statistics != nullptr){
+        *statistics = search.statistics;
+    }
+    return found;
+}
+
+int OptimalSolver::Estimate(const CubeState& state) const{
+    return Estimate(MakeNode(CubieCube::FromState(state)));
+}
+
+size_t OptimalSolver::MemoryFootprint() const{
+    return m_corners.Bytes() + m_edges[0].Bytes() + m_edges[1].Bytes()
+         + m_cornerPermMove.size()*sizeof(uint16_t) + m_twistMove.size()*sizeof(uint16_t)
+         + sizeof(m_edgeMove) + m_cornerClass.size()*sizeof(uint16_t)
+         + m_cornerClassSymmetry.size() + m_twistConjugate.size()*sizeof(uint16_t);
+}
+
+const PatternDatabase& OptimalSolver::Table(int table) const{
+    return table == 0 ? m_corners : m_edges[table-1];
+}
+
+const char* OptimalSolver::TableName(int table){
+    static const char* names[NUM_TABLES] = {"corners", "edges0", "edges1"};
+    return names[table];
+}
+
+int OptimalSolver::TablesLoaded() const{
+    return m_tablesLoaded;
+}
+
+bool OptimalSolver::SaveTables(const std::string& tableDirectory) const{
+    for (int table=0; table<NUM_TABLES; table++){
+        if (!Table(table).Save(TablePath(tableDirectory, table), TableName(table))){
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string OptimalSolver::TablePath(const std::string& tableDirectory, int table){
+    return tableDirectory + "/" + TableName(table) + ".pdb";
+}
+
+uint64_t OptimalSolver::TableSize(int table){
+    return table == 0 ? NUM_CORNER_STATES : NUM_EDGE_STATES;
+}
+
+OptimalSolver::Node OptimalSolver::MakeNode(const CubieCube& cube) const{
+    Node node;
+    node.cornerPerm = cube.CornerPerm();
+    node.twist = cube.Twist();
+    for (int position=0; position<CubeState::NUM_EDGES; position++){
+        node.edges[cube.ep[position]] = position*2 + cube.eo[position];
+    }
+    return node;
+}
+
+OptimalSolver::Node OptimalSolver::ApplyMove(const Node& node, int move) const{
+    Node moved;
+    moved.cornerPerm = m_cornerPermMove[node.cornerPerm*CubeState::NUM_FACE_MOVES + move];
+    moved.twist = m_twistMove[node.twist*CubeState::NUM_FACE_MOVES + move];
+    for (int i=0; i<CubeState::NUM_EDGES; i++){
+        moved.edges[i] = m_edgeMove[node.edges[i]][move];
+    }
+    return moved;
+}
+
+int OptimalSolver::Estimate(const Node& node) const{
+    int corners = m_corners.Get(CornerIndex(node.cornerPerm, node.twist));
+    int edges0 = m_edges[0].Get(EdgeIndex(node.edges));
+    int edges1 = m_edges[1].Get(EdgeIndex(node.edges + PATTERN_EDGES));
+    return std::max(corners, std::max(edges0, edges1));
+}
+
+bool OptimalSolver::Search(struct Search& search, const Node& node, int depth, int bound, int estimate) const{
+    if (search.firstSolvedTask != nullptr
+        && search.firstSolvedTask->load(std::memory_order_relaxed) < search.task){
+        return false;
+    }
+    // every pattern is solved only when the whole cube is
+    if (estimate == 0){
+        return depth == bound;
+    }
+
+    // make every child first so the pattern database reads for all of
+    // them are in flight at once, the tables are far larger than the cache
+    int previous = depth > 0 ? search.moves[depth-1] : -1;
+    Node children[CubeState::NUM_FACE_MOVES];
+    uint64_t cornerIndex[CubeState::NUM_FACE_MOVES];
+    for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+        if (MoveTables::RedundantFaceTurn(m, previous)){
+            continue;
+        }
+        children[m] = ApplyMove(node, m);
+        cornerIndex[m] = CornerIndex(children[m].cornerPerm, children[m].twist);
+        m_corners.Prefetch(cornerIndex[m]);
+    }
+
+    for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+        if (MoveTables::RedundantFaceTurn(m, previous)){
+            continue;
+        }
+        search.statistics.nodes++;
+        // cheapest estimate first, most children are cut off by one of them
+        int childEstimate = m_corners.Get(cornerIndex[m]);
+        if (depth + 1 + childEstimate > bound){
+            continue;
+        }
+        childEstimate = std::max(childEstimate, m_edges[0].Get(EdgeIndex(children[m].edges)));
+        if (depth + 1 + childEstimate > bound){
+            continue;
+        }
+        childEstimate = std::max(childEstimate, m_edges[1].Get(EdgeIndex(children[m].edges + PATTERN_EDGES)));
+        if (depth + 1 + childEstimate > bound){
+            continue;
+        }
+        search.moves[depth] = m;
+        if (Search(search, children[m], depth+1, bound, childEstimate)){
+            return true;
+        }
+    }
+    return false;
+}
+
+void OptimalSolver::SplitTasks(struct Search& search, const Node& node, int depth, int bound, int estimate,
+                               std::vector<Task>& tasks) const{
+    if (depth == SPLIT_DEPTH){
+        Task task;
+        task.node = node;
+        task.estimate = estimate;
+        std::copy(search.moves, search.moves + SPLIT_DEPTH, task.moves);
+        tasks.push_back(task);
+        return;
+    }
+    // solved above the split depth, but the bound is deeper
+    if (estimate == 0){
+        return;
+    }
+    int previous = depth > 0 ? search.moves[depth-1] : -1;
+    for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+        if (MoveTables::RedundantFaceTurn(m, previous)){
+            continue;
+        }
+        search.statistics.nodes++;
+        Node child = ApplyMove(node, m);
+        int childEstimate = Estimate(child);
+        if (depth + 1 + childEstimate > bound){
+            continue;
+        }
+        search.moves[depth] = m;
+        SplitTasks(search, child, depth+1, bound, childEstimate, tasks);
+    }
+}
+
+bool OptimalSolver::SearchParallel(struct Search& search, Pool& pool, const Node& root, int bound, int estimate) const{
+    std::vector<Task> tasks;
+    SplitTasks(search, root, 0, bound, estimate, tasks);
+    if (tasks.empty()){
+        return false;
+    }
+    pool.Run(tasks, bound);
+
+    int first = pool.firstSolvedTask.load();
+    bool found = first != INT_MAX;
+    for (int worker=0; worker<pool.threads; worker++){
+        search.statistics.nodes += pool.searches[worker].statistics.nodes;
+        if (found && pool.solvedTask[worker] == first){
+            std::copy(pool.solvedMoves[worker].begin(), pool.solvedMoves[worker].end(), search.moves);
+        }
+    }
+    return found;
+}
+
+OptimalSolver::GoalNode OptimalSolver::ApplyMove(const GoalNode& node, int move) const{
+    GoalNode moved;
+    moved.node = ApplyMove(node.node, move);
+    for (int i=0; i<CubeState::NUM_CORNERS; i++){
+        moved.corners[i] = m_cornerMove[node.corners[i]][move];
+    }
+    return moved;
+}
+
+int OptimalSolver::GoalEstimate(const GoalNode& node, int cornerMask, int edgeMask) const{
+    // a database only bounds goals that keep every piece in it
+    int estimate = 0;
+    if (cornerMask == Goal::ALL_CORNERS){
+        estimate = m_corners.Get(CornerIndex(node.node.cornerPerm, node.node.twist));
+    }
+    for (int pattern=0; pattern<2; pattern++){
+        int patternMask = ((1 << PATTERN_EDGES) - 1) << (pattern*PATTERN_EDGES);
+        if ((edgeMask & patternMask) == patternMask){
+            estimate = std::max(estimate, m_edges[pattern].Get(EdgeIndex(node.node.edges + pattern*PATTERN_EDGES)));
+        }
+    }
+    // every piece needs at least its own distance, and a face turn moves
+    // four corners and four edges one step each
+    int cornerSum = 0;
+    for (int i=0; i<CubeState::NUM_CORNERS; i++){
+        if (cornerMask & (1 << i)){
+            int distance = m_cornerDistance[i][node.corners[i]];
+            estimate = std::max(estimate, distance);
+            cornerSum += distance;
+        }
+    }
+    int edgeSum = 0;
+    for (int i=0; i<CubeState::NUM_EDGES; i++){
+        if (edgeMask & (1 << i)){
+            int distance = m_edgeDistance[i][node.node.edges[i]];
+            estimate = std::max(estimate, distance);
+            edgeSum += distance;
+        }
+    }
+    return std::max(estimate, std::max((cornerSum + 3)/4, (edgeSum + 3)/4));
+}
+
+bool OptimalSolver::SearchGoal(struct Search& search, const GoalNode& node, int cornerMask, int edgeMask,
+                               int depth, int bound, int estimate) const{
+    // no piece the goal keeps is away from home
+    if (estimate == 0){
+        return depth == bound;
+    }
+    int previous = depth > 0 ? search.moves[depth-1] : -1;
+    for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+        if (MoveTables::RedundantFaceTurn(m, previous)){
+            continue;
+        }
+        search.statistics.nodes++;
+        GoalNode child = ApplyMove(node, m);
+        int childEstimate = GoalEstimate(child, cornerMask, edgeMask);
+        if (depth + 1 + childEstimate > bound){
+            continue;
+        }
+        search.moves[depth] = m;
+        if (SearchGoal(search, child, cornerMask, edgeMask, depth+1, bound, childEstimate)){
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,185 @@
+#include "PatternDatabase.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char FILE_MAGIC[8] = "CUBEPDB";
+    const uint32_t BITS_PER_ENTRY = 4;
+}
+
+PatternDatabase::PatternDatabase(){
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+    m_mappingBytes = 0;
+}
+
+PatternDatabase::~PatternDatabase(){
+    Unmap();
+}
+
+void PatternDatabase::Reset(uint64_t size){
+    Unmap();
+    m_size = size;
+    // both nibbles of every byte start out UNKNOWN
+    m_nibbles.assign((size + 1)/2, (UNKNOWN << 4) | UNKNOWN);
+    m_data = m_nibbles.data();
+}
+
+void PatternDatabase::Set(uint64_t index, int value){
+    uint8_t& byte = m_nibbles[index >> 1];
+    int shift = (index & 1) << 2;
+    byte = (byte & ~(0x0F << shift)) | (value << shift);
+}
+
+bool PatternDatabase::Claim(uint64_t index, int value){
+    uint8_t* byte = &m_nibbles[index >> 1];
+    int shift = (index & 1) << 2;
+    uint8_t current = __atomic_load_n(byte, __ATOMIC_RELAXED);
+    uint8_t desired;
+    // the other entry in the byte may be claimed by another thread meanwhile
+    do{
+        if (((current >> shift) & 0x0F) != UNKNOWN){
+            return false;
+        }
+        desired = (current & ~(0x0F << shift)) | (value << shift);
+    } while (!__atomic_compare_exchange_n(byte, &current, desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    return true;
+}
+
+uint64_t PatternDatabase::Size() const{
+    return m_size;
+}
+
+size_t PatternDatabase::Bytes() const{
+    return (m_size + 1)/2;
+}
+
+bool PatternDatabase::IsMapped() const{
+    return m_mapping != nullptr;
+}
+
+std::vector<uint64_t> PatternDatabase::DepthCounts() const{
+    std::vector<uint64_t> counts(UNKNOWN + 1, 0);
+    for (uint64_t i=0; i<m_size; i++){
+        counts[Get(i)]++;
+    }
+    return counts;
+}
+
+PatternDatabase::FileHeader PatternDatabase::MakeHeader(const std::string& name, uint64_t size){
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+    header.version = FILE_VERSION;
+    header.bitsPerEntry = BITS_PER_ENTRY;
+    header.entries = size;
+    std::strncpy(header.name, name.c_str(), sizeof(header.name) - 1);
+    header.dataOffset = FILE_DATA_OFFSET;
+    return header;
+}
+
+bool PatternDatabase::Save(const std::string& path, const std::string& name) const{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file){
+        std::cout << "Could not write pattern database " << path << std::endl;
+        return false;
+    }
+    std::vector<char> page(FILE_DATA_OFFSET, 0);
+    FileHeader header = MakeHeader(name, m_size);
+    std::memcpy(page.data(), &header, sizeof(header));
+    file.write(page.data(), page.size());
+    file.write(reinterpret_cast<const char*>(m_data), Bytes());
+    if (!file){
+        std::cout << "Could not write pattern database " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool PatternDatabase::Load(const std::string& path, const std::string& name, uint64_t size){
+    FileHeader expected = MakeHeader(name, size);
+    FileHeader header;
+    uint64_t fileBytes = 0;
+#if defined(_WIN32)
+    // no mmap here, read the whole table instead
+    std::ifstream file(path, std::ios::binary);
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header))){
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    fileBytes = file.tellg();
+#else
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0){
+        return false;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || uint64_t(status.st_size) < sizeof(header)){
+        close(descriptor);
+        std::cout << "Pattern database " << path << " is too short" << std::endl;
+        return false;
+    }
+    fileBytes = status.st_size;
+    void* mapping = mmap(nullptr, fileBytes, PROT_READ, MAP_SHARED, descriptor, 0);
+    // the mapping stays valid once the file is closed
+    close(descriptor);
+    if (mapping == MAP_FAILED){
+        std::cout << "Could not map pattern database " << path << std::endl;
+        return false;
+    }
+    std::memcpy(&header, mapping, sizeof(header));
+#endif
+
+    if (std::memcmp(&header, &expected, sizeof(header)) != 0
+        || fileBytes < FILE_DATA_OFFSET + (size + 1)/2){
+        std::cout << "Pattern database " << path << " is not " << name << " version " << FILE_VERSION
+                  << " with " << size << " entries, generate it again" << std::endl;
+#if !defined(_WIN32)
+        munmap(mapping, fileBytes);
+#endif
+        return false;
+    }
+
+    Unmap();
+    m_size = size;
+#if defined(_WIN32)
+    m_nibbles.resize((size + 1)/2);
+    file.seekg(FILE_DATA_OFFSET);
+    if (!file.read(reinterpret_cast<char*>(m_nibbles.data()), m_nibbles.size())){
+        std::cout << "Could not read pattern database " << path << std::endl;
+        Reset(0);
+        return false;
+    }
+    m_data = m_nibbles.data();
+#else
+    // lookups jump all over the table, reading ahead would only waste memory
+    madvise(mapping, fileBytes, MADV_RANDOM);
+    m_nibbles.clear();
+    m_nibbles.shrink_to_fit();
+    m_mapping = mapping;
+    m_mappingBytes = fileBytes;
+    m_data = static_cast<const uint8_t*>(mapping) + FILE_DATA_OFFSET;
+#endif
+    return true;
+}
+
+void PatternDatabase::Unmap(){
+#if !defined(_WIN32)
+    if (m_mapping != nullptr){
+        munmap(m_mapping, m_mappingBytes);
+    }
+#endif
+    m_mapping = nullptr;
+    m_mappingBytes = 0;
+    m_data = m_nibbles.data();
+}
@@ -0,0 +1,136 @@
+#include "PocketCube.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+    // positions of the corners that move, every one but DBL (6)
+    const int MOVING_CORNERS = 7;
+    const int POSITIONS[MOVING_CORNERS] = {0, 1, 2, 3, 4, 5, 7};
+
+    // which of the moving corners a corner piece is
+    int MovingCorner(int piece){
+        return piece == 7 ? 6 : piece;
+    }
+
+    int Perm(const CubieCube& cube){
+        uint8_t values[MOVING_CORNERS];
+        for (int i=0; i<MOVING_CORNERS; i++){
+            values[i] = MovingCorner(cube.cp[POSITIONS[i]]);
+        }
+        return CubieCube::PermIndex(values, MOVING_CORNERS);
+    }
+
+    void SetPerm(CubieCube& cube, int perm){
+        uint8_t values[MOVING_CORNERS];
+        CubieCube::SetPerm(values, MOVING_CORNERS, perm, 0);
+        for (int i=0; i<MOVING_CORNERS; i++){
+            cube.cp[POSITIONS[i]] = POSITIONS[values[i]];
+        }
+    }
+
+    // orientations of the first six moving corners, base 3
+    int Twist(const CubieCube& cube){
+        int twist = 0;
+        for (int i=0; i<MOVING_CORNERS-1; i++){
+            twist = twist*3 + cube.co[POSITIONS[i]];
+        }
+        return twist;
+    }
+
+    void SetTwist(CubieCube& cube, int twist){
+        int sum = 0;
+        for (int i=MOVING_CORNERS-2; i>=0; i--){
+            cube.co[POSITIONS[i]] = twist % 3;
+            sum += twist % 3;
+            twist /= 3;
+        }
+        // DBL is never twisted, and the total twist is a multiple of three
+        cube.co[POSITIONS[MOVING_CORNERS-1]] = (3 - sum % 3) % 3;
+    }
+
+    template<typename Set, typename Get>
+    std::vector<uint16_t> BuildMoveTable(int size, Set set, Get get){
+        std::vector<uint16_t> table(size*PocketCube::NUM_MOVES);
+        for (int i=0; i<size; i++){
+            CubieCube cube = CubieCube::Solved();
+            set(cube, i);
+            // U R F are the first nine face turns
+            for (int move=0; move<PocketCube::NUM_MOVES; move++){
+                table[i*PocketCube::NUM_MOVES + move] = get(cube.Multiply(CubieCube::FaceMove(move)));
+            }
+        }
+        return table;
+    }
+}
+
+PocketCube::PocketCube(){
+    m_permMove = BuildMoveTable(NUM_PERMS, SetPerm, Perm);
+    m_twistMove = BuildMoveTable(NUM_TWISTS, SetTwist, Twist);
+}
+
+int PocketCube::Index(const CubieCube& cube){
+    return Perm(cube)*NUM_TWISTS + Twist(cube);
+}
+
+std::vector<uint64_t> PocketCube::Enumerate(int threads) const{
+    if (threads <= 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t words = (NUM_STATES + 63)/64;
+    std::vector<uint64_t> visited(words, 0);
+    std::vector<uint64_t> frontier(words, 0);
+    std::vector<uint64_t> next(words, 0);
+    int solved = Index(CubieCube::Solved());
+    visited[solved >> 6] |= uint64_t(1) << (solved & 63);
+    frontier[solved >> 6] |= uint64_t(1) << (solved & 63);
+
+    std::vector<uint64_t> counts(1, 1);
+    for (;;){
+        // each thread expands the frontier states in its share of the
+        // words, any thread may mark any state of the next level
+        std::vector<uint64_t> found(threads, 0);
+        auto expand = [&](int thread){
+            uint64_t count = 0;
+            size_t end = words*(thread+1)/threads;
+            for (size_t word=words*thread/threads; word<end; word++){
+                for (uint64_t bits = frontier[word]; bits != 0; bits &= bits - 1){
+                    int index = word*64 + __builtin_ctzll(bits);
+                    for (int move=0; move<NUM_MOVES; move++){
+                        int moved = Move(index, move);
+                        uint64_t bit = uint64_t(1) << (moved & 63);
+                        if (__atomic_load_n(&visited[moved >> 6], __ATOMIC_RELAXED) & bit){
+                            continue;
+                        }
+                        // only the thread that sets the bit counts the state
+                        if (!(__atomic_fetch_or(&visited[moved >> 6], bit, __ATOMIC_RELAXED) & bit)){
+                            __atomic_fetch_or(&next[moved >> 6], bit, __ATOMIC_RELAXED);
+                            count++;
+                        }
+                    }
+                }
+            }
+            found[thread] = count;
+        };
+        std::vector<std::thread> workers;
+        for (int thread=1; thread<threads; thread++){
+            workers.emplace_back(expand, thread);
+        }
+        expand(0);
+        for (std::thread& worker : workers){
+            worker.join();
+        }
+
+        uint64_t total = 0;
+        for (uint64_t count : found){
+            total += count;
+        }
+        if (total == 0){
+            break;
+        }
+        counts.push_back(total);
+        frontier.swap(next);
+        std::fill(next.begin(), next.end(), 0);
+    }
+    return counts;
+}
@@ -0,0 +1,52 @@
+#include "RandomState.hpp"
+#include "MoveTables.hpp"
+
+namespace {
+    const uint32_t NUM_CORNER_PERMS = 40320;        // 8!
+    const uint32_t NUM_EDGE_PERMS = 479001600;      // 12!
+    const uint32_t NUM_TWISTS = 2187;               // 3^7
+    const uint32_t NUM_FLIPS = 2048;                // 2^11
+
+    // parity of the permutation with a Lehmer code, the sum of its digits
+    int Parity(uint32_t index, int n){
+        int parity = 0;
+        for (int i=n-1; i>=0; i--){
+            parity += index % (n-i);
+            index /= (n-i);
+        }
+        return parity & 1;
+    }
+}
+
+CubieCube RandomState::Generate(uint64_t seed, uint64_t index){
+    Philox random(seed, index);
+    return Generate(random);
+}
+
+CubieCube RandomState::Generate(Philox& random){
+    CubieCube cube;
+    uint32_t cornerPerm = random.Below(NUM_CORNER_PERMS);
+    uint32_t edgePerm = random.Below(NUM_EDGE_PERMS);
+    // the last digit but one swaps the last two edges, the others are then
+    // as likely as before
+    if (Parity(cornerPerm, CubeState::NUM_CORNERS) != Parity(edgePerm, CubeState::NUM_EDGES)){
+        edgePerm ^= 1;
+    }
+    cube.SetCornerPerm(cornerPerm);
+    CubieCube::SetPerm(cube.ep, CubeState::NUM_EDGES, edgePerm, 0);
+    cube.SetTwist(random.Below(NUM_TWISTS));
+    cube.SetFlip(random.Below(NUM_FLIPS));
+    return cube;
+}
+
+std::vector<Move> RandomState::Scramble(const CubieCube& cube, const ThistlethwaiteSolver& solver){
+    std::vector<Move> solution;
+    std::vector<Move> scramble;
+    if (!solver.Solve(cube.ToState(), solution)){
+        return scramble;
+    }
+    for (auto move = solution.rbegin(); move != solution.rend(); ++move){
+        scramble.push_back(MoveTables::Inverse(*move));
+    }
+    return scramble;
+}
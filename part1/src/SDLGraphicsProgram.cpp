@@ -2,7 +2,11 @@
 #include "Camera.hpp"
 #include "ObjectManager.hpp"
 #include "Cube.hpp"
+#include "MoveParser.hpp"
+#include "MoveSimplifier.hpp"
+#include "RandomState.hpp"
 
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -18,8 +22,6 @@ SDLGraphicsProgram::SDLGraphicsProgram(int w, int h):m_screenWidth(w),m_screenHe
 	std::stringstream errorStream;
 	// The window we'll be rendering to
 	m_window = NULL;
-	// rotation state
-    rotationState = Rotation::NONE;
 
 	// Initialize SDL
 	if(SDL_Init(SDL_INIT_VIDEO)< 0){
@@ -56,6 +58,9 @@ SDLGraphicsProgram::SDLGraphicsProgram(int w, int h):m_screenWidth(w),m_screenHe
 			success = false;
 		}
 
+		// Sync buffer swaps with the display, turn timing comes from the animation clock
+		SDL_GL_SetSwapInterval(1);
+
 		// Initialize GLAD Library
 		if(!gladLoadGLLoader(SDL_GL_GetProcAddress)){
 			errorStream << "Failed to iniitalize GLAD\n";
@@ -82,6 +87,8 @@ SDLGraphicsProgram::SDLGraphicsProgram(int w, int h):m_screenWidth(w),m_screenHe
 	// GetOpenGLVersionInfo();
 
     LoadCubes();
+    solutionCache.OpenFile(SOLUTION_CACHE_FILE);
+    randomSeed = std::chrono::system_clock::now().time_since_epoch().count();
 }
 
 
@@ -111,43 +118,11 @@ bool SDLGraphicsProgram::InitGL(){
 
 // Update OpenGL
 void SDLGraphicsProgram::Update(){
-    // variable for rotating sub cubes
-    static float rot = 0;
-
-    // when actively rotating, update rot
-    if (rotationState != Rotation::NONE) {
-        rot += M_PI_2/40;
-    }
-    
-    // link absolute position to current subcube
-    for(int i=0; i<NUM_SUB_CUBES; i++) {
-        glm::vec3 cubePos = idxToPositionMap.at(i);
-        int subCubeIdx = subCubePositions[i];
-
-        // note: this is the identity + identity rotation already
-        ObjectManager::Instance().GetObject(subCubeIdx).GetTransform().LoadIdentity();
-
-        std::vector<int> rotIdxs = rotationMap.at(rotationState);
-
-        if (rotationState != Rotation::NONE && std::find(rotIdxs.begin(), rotIdxs.end(), i) != rotIdxs.end()) {
-            // if actively rotating -> rotate then translate to achieve "orbit" effect
-            ObjectManager::Instance().GetObject(subCubeIdx).GetTransform().Rotate(rotationDirection*rot, rotationTypeMap.at(rotationAxes.at(rotationState)));
-        }
-
-        // translate the sub cube to the absolute cub position
-        ObjectManager::Instance().GetObject(subCubeIdx).GetTransform().Translate(cubePos);
-        // perform final rotations to make sure cube is facing right direction when rotation completes
-        ObjectManager::Instance().GetObject(subCubeIdx).GetTransform().ApplyIdentityRotation();
-        // scale the cubes
-        ObjectManager::Instance().GetObject(subCubeIdx).GetTransform().Scale(.49f,.49f,.49f);
-    }
-
-    // reached M_PI/2 radians (90 degrees) => rotation has finished
-    // reset rotation state & rot, update subCubePositions
-    if (rot >= M_PI_2) {
-        UpdateSubCubePositions();
-        rotationState = Rotation::NONE;
-        rot = 0;
+    // the simulation lays out every sub cube, interpolating between its
+    // last two steps so motion stays smooth at any frame rate
+    simulation.ComputeTransforms(animationClock.Alpha());
+    for(int i=0; i<CubeSimulation::NUM_SUB_CUBES; i++) {
+        ObjectManager::Instance().GetObject(i).GetTransform() = simulation.GetTransform(i);
     }
 
     // Update all of the objects
@@ -180,9 +155,6 @@ void SDLGraphicsProgram::Render(){
 
     // Render all of our objects in a simple loop
     ObjectManager::Instance().RenderAll();
- 
-	// Delay to slow things down just a bit!
-    SDL_Delay(15); 
 }
 
 
@@ -201,6 +173,10 @@ void SDLGraphicsProgram::Loop(){
     float cameraSpeed = 1.0f;
     Camera::Instance().Reset();
 
+    // wall clock time of the previous frame
+    auto lastFrame = std::chrono::steady_clock::now();
+    animationClock.Reset();
+
     // While application is running
     while(!quit){
      	     	 //Handle events on queue
@@ -248,35 +224,58 @@ void SDLGraphicsProgram::Loop(){
                     case SDLK_BACKQUOTE:
                         rotationDirection *= -1;
                         break;
+                    // C to toggle speeding up queued moves
+                    case SDLK_c:
+                        simulation.SetCollapseQueuedMoves(!simulation.GetCollapseQueuedMoves());
+                        break;
+                    // -/= to slow down/speed up turns
+                    case SDLK_MINUS:
+                        simulation.SetTurnDuration(simulation.GetTurnDuration()*1.5f);
+                        break;
+                    case SDLK_EQUALS:
+                        simulation.SetTurnDuration(simulation.GetTurnDuration()/1.5f);
+                        break;
                     // 1-3 to update roll
                     case SDLK_1:
-                        UpdateRotationState(Rotation::FRONT_Z);
+                        QueueRotation(Rotation::FRONT_Z);
                         break;
                     case SDLK_2:
-                        UpdateRotationState(Rotation::MID_Z);
+                        QueueRotation(Rotation::MID_Z);
                         break;
                     case SDLK_3:
-                        UpdateRotationState(Rotation::BACK_Z);
+                        QueueRotation(Rotation::BACK_Z);
                         break;
                     // 4-6 to update pitch
                     case SDLK_4:
-                        UpdateRotationState(Rotation::TOP_Y);
+                        QueueRotation(Rotation::TOP_Y);
                         break;
                     case SDLK_5:
-                        UpdateRotationState(Rotation::MID_Y);
+                        QueueRotation(Rotation::MID_Y);
                         break;
                     case SDLK_6:
-                        UpdateRotationState(Rotation::BOTTOM_Y);
+                        QueueRotation(Rotation::BOTTOM_Y);
                         break;
                     // 7-9 to update yaw
                     case SDLK_7:
-                        UpdateRotationState(Rotation::LEFT_X);
+                        QueueRotation(Rotation::LEFT_X);
                         break;
                     case SDLK_8:
-                        UpdateRotationState(Rotation::MID_X);
+                        QueueRotation(Rotation::MID_X);
                         break;
                     case SDLK_9:
-                        UpdateRotationState(Rotation::RIGHT_X);
+                        QueueRotation(Rotation::RIGHT_X);
+                        break;
+                    // ENTER to solve the cube
+                    case SDLK_RETURN:
+                        SolveCube();
+                        break;
+                    // L to solve layer by layer
+                    case SDLK_l:
+                        SolveLayerByLayer();
+                        break;
+                    // Z to scramble to a random state
+                    case SDLK_z:
+                        ScrambleCube();
                         break;
                     // quit project
                     case SDLK_q:
@@ -284,6 +283,15 @@ void SDLGraphicsProgram::Loop(){
                         break;
                 }
       	    } // End SDL_PollEvent loop.
+        }
+        PollSolver();
+        FeedPendingMoves();
+        // Advance the simulation in fixed steps of wall clock time
+        auto now = std::chrono::steady_clock::now();
+        int steps = animationClock.Advance(std::chrono::duration<double>(now - lastFrame).count());
+        lastFrame = now;
+        for(int i=0; i<steps; i++){
+            simulation.Step(animationClock.StepSeconds());
         }
 		// Update our scene
 		Update();
@@ -317,8 +325,7 @@ void SDLGraphicsProgram::LoadCubes(){
     std::cout<<"Loading...\n";
 
     // create all cube objects - indexed left-to-right, top-to-bottom, front-to-back
-    for (int i=0; i<NUM_SUB_CUBES; i++){
-        subCubePositions.push_back(i);
+    for (int i=0; i<CubeSimulation::NUM_SUB_CUBES; i++){
         Object* subCube = new Object();
         subCube->LoadTextureQuad("./cube/cube.obj", ("./cube/textures/cube" + std::to_string(i) + ".ppm"));
         ObjectManager::Instance().AddObject(subCube);
@@ -332,68 +339,195 @@ void SDLGraphicsProgram::LoadCubes(){
     std::cout<<" • You will travel in the direction you're looking. Use your mouse to look around.\n";
     std::cout<<" • Use the number keys [1-9] to rotate the cube.\n";
     std::cout<<" • Press tilde (~) to change the rotation direction.\n";
+    std::cout<<" • Key presses queue up. Press c to speed through long queues, - and = to change turn speed.\n";
+    std::cout<<" • Press ENTER to solve the cube, l to solve it layer by layer, z to scramble it to a random state.\n";
+    if (!cfopSolver.HasTables()) {
+        std::cout<<"   (l is off until ./llgen "<<CFOP_TABLE_DIRECTORY<<" writes the layer by layer tables)\n";
+    }
+    std::cout<<" • Pass a move script (e.g. ./project scramble.txt) to play it back on the cube.\n";
     std::cout<<" • Press q to quit.\n";
     std::cout<<"====================================================================================\n";
 }
 
-void SDLGraphicsProgram::UpdateSubCubePositions(){
-    // update identity rotation for rotated cubes, keep temp map of absolute index (i) to sub cube index
-    std::map<int,int> absToSubCubeMap;
-    for(int i : rotationMap.at(rotationState)){
-        int subCubeIdx = subCubePositions[i];
-        absToSubCubeMap[i] = subCubeIdx;
-        ObjectManager::Instance().GetObject(subCubeIdx).GetTransform()
-            .UpdateIdentityRotation(rotationAxes.at(rotationState), rotationDirection*M_PI_2);
+// queue a rotation in the current direction, dropped only if the queue is full
+void SDLGraphicsProgram::QueueRotation(Rotation rotation){
+    if (!simulation.QueueMove(GetMove(rotation))) {
+        std::cout<<"Move queue is full, ignoring rotation\n";
     }
+}
 
-    // update subcubepositions based on postRotationMap
-    std::map<int,int> newPositions = GetUpdatedIndices(rotationMap.at(rotationState));
+// parse a whole script up front, it is played back from Loop
+bool SDLGraphicsProgram::LoadScript(const std::string& path){
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout<<"Could not open move script "<<path<<"\n";
+        return false;
+    }
+    std::vector<Move> moves;
+    MoveParser::VectorSink sink(moves);
+    MoveParser parser(sink);
+    if (!parser.ParseStream(file)) {
+        std::cout<<"Error in move script "<<path<<", "<<parser.GetError()<<"\n";
+        return false;
+    }
+    // no point animating turns that cancel out
+    size_t parsedMoves = moves.size();
+    MoveSimplifier::Simplify(moves);
+    pendingMoves.insert(pendingMoves.end(), moves.begin(), moves.end());
+    std::cout<<"Loaded "<<moves.size()<<" moves ("<<parsedMoves<<" before simplifying) from "<<path<<"\n";
+    return true;
+}
 
-    for(int i : rotationMap.at(rotationState)){
-        subCubePositions[i] = absToSubCubeMap[newPositions[i]];
+// top up the queue from the pending moves, key presses still fit in between
+void SDLGraphicsProgram::FeedPendingMoves(){
+    while (pendingPosition < pendingMoves.size() && simulation.QueuedMoves() < MoveQueue::CAPACITY/2) {
+        simulation.QueueMove(pendingMoves[pendingPosition++]);
     }
+    if (pendingPosition > 0 && pendingPosition == pendingMoves.size()) {
+        pendingMoves.clear();
+        pendingPosition = 0;
+    }
+}
+
+CubeState SDLGraphicsProgram::GetPendingState() const{
+    CubeState state = simulation.GetQueuedState();
+    for(size_t i=pendingPosition; i<pendingMoves.size(); i++){
+        state.ApplyMove(pendingMoves[i]);
+    }
+    return state;
 }
 
-// update rotation state if not set
-void SDLGraphicsProgram::UpdateRotationState(Rotation rotation){
-    if (rotationState == Rotation::NONE) {
-        rotationState = rotation;
+// cached states are queued at once, anything else is left to the background search
+void SDLGraphicsProgram::SolveCube(){
+    CubeState state = GetPendingState();
+    std::vector<Move> solution;
+    auto start = std::chrono::steady_clock::now();
+    if (solutionCache.Lookup(state, solution)) {
+        QueueSolution(solution, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), true);
+        return;
     }
+    anytimeSolver.Start(state, SOLVE_TARGET_LENGTH, SOLVE_IMPROVE_SECONDS);
+    solveWaiting = true;
+    solveStart = start;
+    solveVersion = 0;
 }
 
-// rotate a flat 1D vector, these are the updated positions for the subcubes post-rotation
-std::map<int, int> SDLGraphicsProgram::GetUpdatedIndices(std::vector<int> face){
-    /*  
-    think about "rotating" 2D array, then flatten
-    0 1 2      6 3 0           
-    3 4 5  ->  7 4 1 
-    6 7 8      8 5 2
-    OR
-    0 1 2      2 5 8
-    3 4 5  ->  1 4 7 
-    6 7 8      0 3 6
-    */
-    std::map<int,int> result;
-    if (rotationDirection == -1){
-        result[face[0]] = face[6];
-        result[face[1]] = face[3];
-        result[face[2]] = face[0];
-        result[face[3]] = face[7];
-        result[face[4]] = face[4];
-        result[face[5]] = face[1];
-        result[face[6]] = face[8];
-        result[face[7]] = face[5];
-        result[face[8]] = face[2];
-    } else if(rotationDirection == 1){
-        result[face[0]] = face[2];
-        result[face[1]] = face[5];
-        result[face[2]] = face[8];
-        result[face[3]] = face[1];
-        result[face[4]] = face[4];
-        result[face[5]] = face[7];
-        result[face[6]] = face[0];
-        result[face[7]] = face[3];
-        result[face[8]] = face[6];
+// the solver publishes solutions as it finds them, this only looks at the latest
+void SDLGraphicsProgram::PollSolver(){
+    if (!solveWaiting && solveVersion == 0) {
+        return;
+    }
+    // read before the solution, so a finished search has published its last one
+    bool running = anytimeSolver.IsRunning();
+    std::vector<Move> solution;
+    int version = anytimeSolver.GetBest(solution);
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - solveStart).count();
+
+    if (solveWaiting) {
+        if (version == 0 && !running) {
+            std::cout<<"This cube can not be solved\n";
+            solveWaiting = false;
+            return;
+        }
+        if (version == 0 || (running && milliseconds < SOLVE_BUDGET_MILLISECONDS)) {
+            return;
+        }
+        solveWaiting = false;
+        solveVersion = version;
+        // keys pressed while solving already changed the state the solution is for
+        if (!(GetPendingState() == anytimeSolver.GetState())) {
+            std::cout<<"The cube was turned while solving, press ENTER again\n";
+            anytimeSolver.Stop();
+            solveVersion = 0;
+            return;
+        }
+        solutionCache.Insert(anytimeSolver.GetState(), solution);
+        QueueSolution(solution, milliseconds, false);
+    } else if (version > solveVersion) {
+        // too late for this solve, but the next one of this state gets it
+        solveVersion = version;
+        solutionCache.Insert(anytimeSolver.GetState(), solution);
+        std::cout<<"Found a shorter solution ("<<solution.size()<<" moves, "<<milliseconds<<" ms), cached for next time: "
+                 <<MoveParser::ToString(solution)<<"\n";
+    }
+    if (!running) {
+        solveVersion = 0;
     }
-    return result;
-}
\ No newline at end of file
+}
+
+void SDLGraphicsProgram::QueueSolution(const std::vector<Move>& solution, double milliseconds, bool cached){
+    std::cout<<"Solution ("<<solution.size()<<" moves, "<<milliseconds<<" ms"<<(cached ? ", cached" : "")<<"): "
+             <<MoveParser::ToString(solution)<<"\n";
+    const SolutionCache::Counters& counters = solutionCache.GetCounters();
+    std::cout<<"Solution cache: "<<solutionCache.Size()<<" solutions, hit rate "<<counters.HitRate()*100.0
+             <<"%, lookup "<<counters.AverageLookupMicroseconds()<<" us on average\n";
+    pendingMoves.insert(pendingMoves.end(), solution.begin(), solution.end());
+}
+
+// the pending state is solved first, so the cube ends up in the random
+// state whatever it looked like before
+void SDLGraphicsProgram::ScrambleCube(){
+    std::vector<Move> moves;
+    if (!scrambler.Solve(GetPendingState(), moves)) {
+        std::cout<<"This cube can not be solved, so it can not be scrambled either\n";
+        return;
+    }
+    CubieCube cube = RandomState::Generate(randomSeed, randomIndex);
+    std::vector<Move> scramble = RandomState::Scramble(cube, scrambler);
+    moves.insert(moves.end(), scramble.begin(), scramble.end());
+    MoveSimplifier::Simplify(moves);
+    std::cout<<"Random state "<<randomIndex<<" of seed "<<randomSeed<<" ("<<moves.size()<<" moves): "
+             <<MoveParser::ToString(scramble)<<"\n";
+    randomIndex++;
+    pendingMoves.insert(pendingMoves.end(), moves.begin(), moves.end());
+}
+
+// a lookup per stage, quick enough to run between two frames
+void SDLGraphicsProgram::SolveLayerByLayer(){
+    if (!cfopSolver.HasTables()) {
+        std::cout<<"No layer by layer tables in "<<CFOP_TABLE_DIRECTORY<<", run ./llgen "<<CFOP_TABLE_DIRECTORY<<" to turn l on\n";
+        return;
+    }
+    std::vector<Move> solution;
+    CfopSolver::Stages stages;
+    auto start = std::chrono::steady_clock::now();
+    if (!cfopSolver.Solve(GetPendingState(), solution, &stages)) {
+        std::cout<<"This cube can not be solved\n";
+        return;
+    }
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout<<"Layer by layer solution ("<<solution.size()<<" moves, "<<milliseconds<<" ms; cross "<<stages.cross<<", pairs";
+    for (int pair=0; pair<CfopSolver::NUM_PAIRS; pair++) {
+        std::cout<<" "<<stages.pairs[pair];
+    }
+    std::cout<<", last layer "<<stages.lastLayer<<"): "<<MoveParser::ToString(solution)<<"\n";
+    pendingMoves.insert(pendingMoves.end(), solution.begin(), solution.end());
+}
+
+// map a slice rotation to a move in notation
+// clockwise (-1) turns the slice clockwise when looking down the positive axis,
+// so it matches F, S, U and R but is the inverse of B, D, L, M and E
+Move SDLGraphicsProgram::GetMove(Rotation rotation) const{
+    bool clockwise = rotationDirection == -1;
+    switch(rotation){
+        case Rotation::FRONT_Z:
+            return clockwise ? Move::F : Move::F_PRIME;
+        case Rotation::MID_Z:
+            return clockwise ? Move::S : Move::S_PRIME;
+        case Rotation::BACK_Z:
+            return clockwise ? Move::B_PRIME : Move::B;
+        case Rotation::TOP_Y:
+            return clockwise ? Move::U : Move::U_PRIME;
+        case Rotation::MID_Y:
+            return clockwise ? Move::E_PRIME : Move::E;
+        case Rotation::BOTTOM_Y:
+            return clockwise ? Move::D_PRIME : Move::D;
+        case Rotation::LEFT_X:
+            return clockwise ? Move::L_PRIME : Move::L;
+        case Rotation::MID_X:
+            return clockwise ? Move::M_PRIME : Move::M;
+        case Rotation::RIGHT_X:
+        default:
+            return clockwise ? Move::R : Move::R_PRIME;
+    }
+}
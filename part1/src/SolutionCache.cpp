@@ -0,0 +1,306 @@
+#include "SolutionCache.hpp"
+#include "CubieCube.hpp"
+#include "Symmetry.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char FILE_MAGIC[8] = "CUBESOL";
+    // entries start here in a file, past the header
+    const size_t FILE_DATA_OFFSET = 64;
+
+    // face turn undoing a face turn, powers 1 2 3 become 3 2 1
+    int InverseFaceMove(int move){
+        return move - move % 3 + 2 - move % 3;
+    }
+
+    // Rotations that bring the centers home, the cubies after them and
+    // the cache key. False if the state can not be cached.
+    bool Normalize(const CubeState& state, std::vector<Move>& rotations, CubeState& rotated,
+                   uint64_t& key, int& symmetry, bool& inverted){
+        if (!CubieCube::FindCenterRotations(state, rotations)){
+            return false;
+        }
+        rotated = state;
+        for (Move rotation : rotations){
+            rotated.ApplyMove(rotation);
+        }
+        CubieCube cube = CubieCube::FromState(rotated);
+        if (!cube.IsSolvable()){
+            return false;
+        }
+        key = Symmetry::CanonicalHash(cube, &symmetry, &inverted);
+        // key 0 marks a free entry, a real key of 0 is stored as 1 instead
+        if (key == 0){
+            key = 1;
+        }
+        return true;
+    }
+}
+
+double SolutionCache::Counters::HitRate() const{
+    return lookups > 0 ? double(hits)/lookups : 0.0;
+}
+
+double SolutionCache::Counters::AverageLookupMicroseconds() const{
+    return lookups > 0 ? lookupSeconds/lookups*1e6 : 0.0;
+}
+
+SolutionCache::SolutionCache(size_t maxBytes){
+    m_entries = nullptr;
+    m_mapping = nullptr;
+    m_mappingBytes = 0;
+    Allocate(maxBytes/sizeof(Entry));
+}
+
+SolutionCache::~SolutionCache(){
+    Unmap();
+}
+
+void SolutionCache::Allocate(size_t entries){
+    // whole sets only, and at least one
+    m_numEntries = std::max<size_t>(entries - entries % WAYS, WAYS);
+    m_memory.assign(m_numEntries, Entry());
+    for (Entry& entry : m_memory){
+        entry.key = 0;
+    }
+    m_entries = m_memory.data();
+    m_hands.assign(m_numEntries/WAYS, 0);
+    m_size = 0;
+}
+
+bool SolutionCache::OpenFile(const std::string& path){
+    FileHeader expected;
+    std::memset(&expected, 0, sizeof(expected));
+    std::memcpy(expected.magic, FILE_MAGIC, sizeof(expected.magic));
+    expected.version = FILE_VERSION;
+    expected.entrySize = sizeof(Entry);
+    expected.entries = m_numEntries;
+    size_t fileBytes = FILE_DATA_OFFSET + m_numEntries*sizeof(Entry);
+    FileHeader header;
+    bool reuse = false;
+
+#if defined(_WIN32)
+    // no mmap here, read the entries now and write them back at the end
+    std::ifstream file(path, std::ios::binary);
+    if (file && file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        && std::memcmp(&header, &expected, sizeof(header)) == 0){
+        file.seekg(FILE_DATA_OFFSET);
+        reuse = bool(file.read(reinterpret_cast<char*>(m_memory.data()), m_numEntries*sizeof(Entry)));
+        if (!reuse){
+            Clear();
+        }
+    }
+    m_writeBackPath = path;
+#else
+    int descriptor = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (descriptor < 0){
+        std::cout << "Could not open solution cache " << path << std::endl;
+        return false;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) == 0 && size_t(status.st_size) == fileBytes
+        && pread(descriptor, &header, sizeof(header), 0) == ssize_t(sizeof(header))){
+        reuse = std::memcmp(&header, &expected, sizeof(header)) == 0;
+    }
+    // anything else is replaced by a cache of the current size, zero is empty
+    if (!reuse && (ftruncate(descriptor, 0) != 0 || ftruncate(descriptor, fileBytes) != 0
+                   || pwrite(descriptor, &expected, sizeof(expected), 0) != ssize_t(sizeof(expected)))){
+        close(descriptor);
+        std::cout << "Could not write solution cache " << path << std::endl;
+        return false;
+    }
+    void* mapping = mmap(nullptr, fileBytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    // the mapping stays valid once the file is closed
+    close(descriptor);
+    if (mapping == MAP_FAILED){
+        std::cout << "Could not map solution cache " << path << std::endl;
+        return false;
+    }
+    Entry* entries = reinterpret_cast<Entry*>(static_cast<char*>(mapping) + FILE_DATA_OFFSET);
+    // a new file takes over what is cached so far
+    if (!reuse){
+        std::copy(m_memory.begin(), m_memory.end(), entries);
+    }
+    Unmap();
+    m_mapping = mapping;
+    m_mappingBytes = fileBytes;
+    m_entries = entries;
+    m_memory.clear();
+    m_memory.shrink_to_fit();
+#endif
+
+    if (reuse){
+        m_size = 0;
+        for (size_t i=0; i<m_numEntries; i++){
+            m_size += m_entries[i].key != 0;
+        }
+    }
+    return true;
+}
+
+void SolutionCache::Unmap(){
+#if defined(_WIN32)
+    if (!m_writeBackPath.empty()){
+        std::ofstream file(m_writeBackPath, std::ios::binary | std::ios::trunc);
+        FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+        header.version = FILE_VERSION;
+        header.entrySize = sizeof(Entry);
+        header.entries = m_numEntries;
+        std::vector<char> start(FILE_DATA_OFFSET, 0);
+        std::memcpy(start.data(), &header, sizeof(header));
+        file.write(start.data(), start.size());
+        file.write(reinterpret_cast<const char*>(m_memory.data()), m_numEntries*sizeof(Entry));
+        m_writeBackPath.clear();
+    }
+#else
+    if (m_mapping != nullptr){
+        munmap(m_mapping, m_mappingBytes);
+    }
+#endif
+    m_mapping = nullptr;
+    m_mappingBytes = 0;
+}
+
+SolutionCache::Entry* SolutionCache::Find(uint64_t key){
+    Entry* set = m_entries + (key % (m_numEntries/WAYS))*WAYS;
+    for (int way=0; way<WAYS; way++){
+        if (set[way].key == key){
+            return &set[way];
+        }
+    }
+    return nullptr;
+}
+
+bool SolutionCache::Lookup(const CubeState& state, std::vector<Move>& solution){
+    auto start = std::chrono::steady_clock::now();
+    m_counters.lookups++;
+    bool hit = false;
+
+    std::vector<Move> rotations;
+    CubeState rotated;
+    uint64_t key;
+    int symmetry;
+    bool inverted;
+    Entry* entry = nullptr;
+    if (Normalize(state, rotations, rotated, key, symmetry, inverted)){
+        entry = Find(key);
+    }
+    if (entry != nullptr){
+        // the entry solves S * state * S^-1 (or S * state^-1 * S^-1),
+        // conjugating its moves by S^-1 brings them back to this state
+        int back = Symmetry::Inverse(symmetry);
+        solution = rotations;
+        for (int i=0; i<entry->length; i++){
+            int move = inverted ? InverseFaceMove(entry->moves[entry->length-1 - i]) : entry->moves[i];
+            solution.push_back(static_cast<Move>(Symmetry::ConjugateMove(move, back)));
+        }
+        // two states sharing a 64 bit key must not get the wrong solution
+        CubeState check = rotated;
+        for (size_t i=rotations.size(); i<solution.size(); i++){
+            check.ApplyMove(solution[i]);
+        }
+        hit = check.IsSolvedIgnoringCenterSpin();
+        if (hit){
+            entry->referenced = 1;
+            m_counters.hits++;
+        }
+    }
+    if (!hit){
+        solution.clear();
+    }
+    m_counters.lookupSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return hit;
+}
+
+void SolutionCache::Insert(const CubeState& state, const std::vector<Move>& solution){
+    std::vector<Move> rotations;
+    CubeState rotated;
+    uint64_t key;
+    int symmetry;
+    bool inverted;
+    if (!Normalize(state, rotations, rotated, key, symmetry, inverted)
+        || solution.size() < rotations.size()
+        || !std::equal(rotations.begin(), rotations.end(), solution.begin())){
+        return;
+    }
+    // face turns after the rotations, the part that is cached
+    std::vector<int> moves;
+    for (size_t i=rotations.size(); i<solution.size(); i++){
+        if (static_cast<int>(solution[i]) >= CubeState::NUM_FACE_MOVES){
+            return;
+        }
+        moves.push_back(static_cast<int>(solution[i]));
+        rotated.ApplyMove(solution[i]);
+    }
+    if (moves.size() > size_t(MAX_SOLUTION_LENGTH) || !rotated.IsSolvedIgnoringCenterSpin()){
+        return;
+    }
+
+    Entry* entry = Find(key);
+    if (entry == nullptr){
+        size_t set = key % (m_numEntries/WAYS);
+        Entry* ways = m_entries + set*WAYS;
+        for (int way=0; way<WAYS && entry == nullptr; way++){
+            if (ways[way].key == 0){
+                entry = &ways[way];
+                m_size++;
+            }
+        }
+        // clock: give every recently used entry a second chance
+        while (entry == nullptr){
+            Entry& candidate = ways[m_hands[set]];
+            m_hands[set] = (m_hands[set] + 1) % WAYS;
+            if (candidate.referenced){
+                candidate.referenced = 0;
+            } else {
+                entry = &candidate;
+                m_counters.evictions++;
+            }
+        }
+    }
+
+    // the moves that solve the canonical representative: conjugated by
+    // S, and for the inverse also reversed and inverted
+    entry->key = key;
+    entry->length = moves.size();
+    entry->referenced = 1;
+    for (size_t i=0; i<moves.size(); i++){
+        int move = inverted ? InverseFaceMove(moves[moves.size()-1 - i]) : moves[i];
+        entry->moves[i] = Symmetry::ConjugateMove(move, symmetry);
+    }
+    m_counters.inserts++;
+}
+
+void SolutionCache::Clear(){
+    for (size_t i=0; i<m_numEntries; i++){
+        m_entries[i].key = 0;
+    }
+    std::fill(m_hands.begin(), m_hands.end(), 0);
+    m_size = 0;
+}
+
+size_t SolutionCache::Size() const{
+    return m_size;
+}
+
+size_t SolutionCache::Capacity() const{
+    return m_numEntries;
+}
+
+const SolutionCache::Counters& SolutionCache::GetCounters() const{
+    return m_counters;
+}
@@ -0,0 +1,314 @@
+#include "Symmetry.hpp"
+#include "MoveTables.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+    const int NUM_TWISTS = 2187;
+    const int NUM_CORNER_PERMS = 40320;
+
+    bool SameCube(const CubieCube& a, const CubieCube& b){
+        return std::memcmp(&a, &b, sizeof(CubieCube)) == 0;
+    }
+
+    // whole cube rotations read off the cube engine
+    CubieCube Rotation(Move move){
+        CubeState state;
+        state.ApplyMove(move);
+        return CubieCube::FromState(state);
+    }
+
+    // left-right mirror: x goes to -x, corners come out mirrored
+    CubieCube Mirror(){
+        CubieCube mirror;
+        for (int i=0; i<CubeState::NUM_CORNERS; i++){
+            for (int j=0; j<CubeState::NUM_CORNERS; j++){
+                const int* a = MoveTables::CORNER_POS[i];
+                const int* b = MoveTables::CORNER_POS[j];
+                if (a[0] == -b[0] && a[1] == b[1] && a[2] == b[2]){
+                    mirror.cp[i] = j;
+                }
+            }
+            mirror.co[i] = 3;
+        }
+        for (int i=0; i<CubeState::NUM_EDGES; i++){
+            for (int j=0; j<CubeState::NUM_EDGES; j++){
+                const int* a = MoveTables::EDGE_POS[i];
+                const int* b = MoveTables::EDGE_POS[j];
+                if (a[0] == -b[0] && a[1] == b[1] && a[2] == b[2]){
+                    mirror.ep[i] = j;
+                }
+            }
+            mirror.eo[i] = 0;
+        }
+        return mirror;
+    }
+
+    struct Tables{
+        CubieCube cubes[Symmetry::NUM_SYMMETRIES];
+        int inverse[Symmetry::NUM_SYMMETRIES];
+        uint8_t moveConjugate[CubeState::NUM_FACE_MOVES][Symmetry::NUM_SYMMETRIES];
+
+        // S * C * S^-1 piece by piece for a cube C that is not mirrored:
+        // position i takes what C has at position from, so piece p ends
+        // up as pieceTo[p], with its orientation looked up
+        uint8_t cornerFrom[Symmetry::NUM_SYMMETRIES][CubeState::NUM_CORNERS];
+        uint8_t cornerTo[Symmetry::NUM_SYMMETRIES][CubeState::NUM_CORNERS];
+        uint8_t cornerOrientation[Symmetry::NUM_SYMMETRIES][CubeState::NUM_CORNERS][CubeState::NUM_CORNERS][3];
+        uint8_t edgeFrom[Symmetry::NUM_SYMMETRIES][CubeState::NUM_EDGES];
+        uint8_t edgeTo[Symmetry::NUM_SYMMETRIES][CubeState::NUM_EDGES];
+        uint8_t edgeFlip[Symmetry::NUM_SYMMETRIES][CubeState::NUM_EDGES][CubeState::NUM_EDGES];
+
+        std::vector<uint16_t> cornerClass;
+        std::vector<uint8_t> cornerClassSymmetry;
+        std::vector<uint16_t> cornerRepresentative;
+        std::vector<uint16_t> cornerStabilizer;
+        std::vector<uint16_t> twistConjugate;
+
+        Tables();
+        CubieCube Conjugate(const CubieCube& cube, int s) const{
+            return cubes[s].Multiply(cube).Multiply(cubes[inverse[s]]);
+        }
+    };
+
+    Tables::Tables(){
+        // every rotation from x and y, the ones keeping U-D first
+        std::vector<CubieCube> rotations = {CubieCube::Solved()};
+        const CubieCube generators[2] = {Rotation(Move::Y), Rotation(Move::X)};
+        for (size_t i=0; i<rotations.size(); i++){
+            for (const CubieCube& generator : generators){
+                CubieCube next = rotations[i].Multiply(generator);
+                bool known = false;
+                for (const CubieCube& rotation : rotations){
+                    known = known || SameCube(rotation, next);
+                }
+                if (!known){
+                    rotations.push_back(next);
+                }
+            }
+        }
+        std::vector<CubieCube> all;
+        CubieCube mirror = Mirror();
+        for (const CubieCube& rotation : rotations){
+            all.push_back(rotation);
+            all.push_back(rotation.Multiply(mirror));
+        }
+        const CubieCube& faceU = CubieCube::FaceMove(static_cast<int>(Move::U));
+        int count = 0;
+        for (int keepsUD=1; keepsUD>=0; keepsUD--){
+            for (const CubieCube& symmetry : all){
+                CubieCube conjugate = symmetry.Multiply(faceU).Multiply(symmetry.Inverse());
+                // U turns into a turn of U or D
+                bool ud = SameCube(conjugate, faceU) || SameCube(conjugate, CubieCube::FaceMove(static_cast<int>(Move::U_PRIME)))
+                       || SameCube(conjugate, CubieCube::FaceMove(static_cast<int>(Move::D)))
+                       || SameCube(conjugate, CubieCube::FaceMove(static_cast<int>(Move::D_PRIME)));
+                if (ud == (keepsUD == 1)){
+                    cubes[count++] = symmetry;
+                }
+            }
+        }
+
+        for (int s=0; s<Symmetry::NUM_SYMMETRIES; s++){
+            for (int t=0; t<Symmetry::NUM_SYMMETRIES; t++){
+                if (SameCube(cubes[s].Multiply(cubes[t]), CubieCube::Solved())){
+                    inverse[s] = t;
+                }
+            }
+            for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+                CubieCube conjugate = cubes[s].Multiply(CubieCube::FaceMove(m)).Multiply(cubes[s].Inverse());
+                for (int n=0; n<CubeState::NUM_FACE_MOVES; n++){
+                    if (SameCube(conjugate, CubieCube::FaceMove(n))){
+                        moveConjugate[m][s] = n;
+                    }
+                }
+            }
+
+            const CubieCube& cube = cubes[s];
+            CubieCube inverseCube = cube.Inverse();
+            for (int i=0; i<CubeState::NUM_CORNERS; i++){
+                cornerFrom[s][i] = inverseCube.cp[i];
+                cornerTo[s][i] = cube.cp[i];
+                // conjugate a lone corner with every orientation
+                for (int piece=0; piece<CubeState::NUM_CORNERS; piece++){
+                    for (int orientation=0; orientation<3; orientation++){
+                        CubieCube single = CubieCube::Solved();
+                        single.co[inverseCube.cp[i]] = orientation;
+                        single.cp[inverseCube.cp[i]] = piece;
+                        cornerOrientation[s][i][piece][orientation] = cube.Multiply(single).Multiply(inverseCube).co[i];
+                    }
+                }
+            }
+            for (int i=0; i<CubeState::NUM_EDGES; i++){
+                edgeFrom[s][i] = inverseCube.ep[i];
+                edgeTo[s][i] = cube.ep[i];
+                for (int piece=0; piece<CubeState::NUM_EDGES; piece++){
+                    edgeFlip[s][i][piece] = cube.eo[piece] ^ inverseCube.eo[i];
+                }
+            }
+        }
+
+        twistConjugate.resize(NUM_TWISTS*Symmetry::NUM_UD_SYMMETRIES);
+        for (int twist=0; twist<NUM_TWISTS; twist++){
+            CubieCube cube = CubieCube::Solved();
+            cube.SetTwist(twist);
+            for (int s=0; s<Symmetry::NUM_UD_SYMMETRIES; s++){
+                twistConjugate[twist*Symmetry::NUM_UD_SYMMETRIES + s] = Conjugate(cube, s).Twist();
+            }
+        }
+
+        // the lowest permutation of every class represents it
+        cornerClass.assign(NUM_CORNER_PERMS, 0xFFFF);
+        cornerClassSymmetry.resize(NUM_CORNER_PERMS);
+        for (int perm=0; perm<NUM_CORNER_PERMS; perm++){
+            if (cornerClass[perm] != 0xFFFF){
+                continue;
+            }
+            CubieCube cube = CubieCube::Solved();
+            cube.SetCornerPerm(perm);
+            int stabilizer = 0;
+            for (int s=0; s<Symmetry::NUM_UD_SYMMETRIES; s++){
+                int conjugate = Conjugate(cube, s).CornerPerm();
+                if (cornerClass[conjugate] == 0xFFFF){
+                    cornerClass[conjugate] = cornerRepresentative.size();
+                    cornerClassSymmetry[conjugate] = inverse[s];
+                }
+                if (conjugate == perm){
+                    stabilizer |= 1 << s;
+                }
+            }
+            cornerRepresentative.push_back(perm);
+            cornerStabilizer.push_back(stabilizer);
+        }
+    }
+
+    const Tables& GetTables(){
+        static const Tables TABLES;
+        return TABLES;
+    }
+
+    // corners and edges of S * C * S^-1 packed in the order of their
+    // positions, so comparing keys compares the cubes. Building a key
+    // stops early, returning UINT64_MAX, as soon as it is sure to come out
+    // above limit: most conjugates differ from the best one so far in the
+    // first piece or two.
+    uint64_t CornerKey(const Tables& tables, const CubieCube& cube, int s, uint64_t limit){
+        uint64_t key = 0;
+        for (int i=0; i<CubeState::NUM_CORNERS; i++){
+            int from = tables.cornerFrom[s][i];
+            int piece = cube.cp[from];
+            key = key << 5 | tables.cornerTo[s][piece] << 2 | tables.cornerOrientation[s][i][piece][cube.co[from]];
+            if (key > limit >> 5*(CubeState::NUM_CORNERS-1 - i)){
+                return UINT64_MAX;
+            }
+        }
+        return key;
+    }
+
+    uint64_t EdgeKey(const Tables& tables, const CubieCube& cube, int s, uint64_t limit){
+        uint64_t key = 0;
+        for (int i=0; i<CubeState::NUM_EDGES; i++){
+            int from = tables.edgeFrom[s][i];
+            int piece = cube.ep[from];
+            key = key << 5 | tables.edgeTo[s][piece] << 1 | (cube.eo[from] ^ tables.edgeFlip[s][i][piece]);
+            if (key > limit >> 5*(CubeState::NUM_EDGES-1 - i)){
+                return UINT64_MAX;
+            }
+        }
+        return key;
+    }
+
+    // smallest keys over the conjugates of cube and its inverse
+    void CanonicalKeys(const CubieCube& cube, uint64_t& cornerKey, uint64_t& edgeKey, int& symmetry, bool& inverted){
+        const Tables& tables = GetTables();
+        const CubieCube candidates[2] = {cube, cube.Inverse()};
+        cornerKey = UINT64_MAX;
+        edgeKey = UINT64_MAX;
+        for (int c=0; c<2; c++){
+            for (int s=0; s<Symmetry::NUM_SYMMETRIES; s++){
+                uint64_t corners = CornerKey(tables, candidates[c], s, cornerKey);
+                if (corners == UINT64_MAX){
+                    continue;
+                }
+                // edges only decide between equal corners
+                uint64_t edges = EdgeKey(tables, candidates[c], s, corners < cornerKey ? UINT64_MAX : edgeKey);
+                if (corners < cornerKey || edges < edgeKey){
+                    cornerKey = corners;
+                    edgeKey = edges;
+                    symmetry = s;
+                    inverted = c == 1;
+                }
+            }
+        }
+    }
+}
+
+const CubieCube& Symmetry::Cube(int symmetry){
+    return GetTables().cubes[symmetry];
+}
+
+int Symmetry::Inverse(int symmetry){
+    return GetTables().inverse[symmetry];
+}
+
+int Symmetry::ConjugateMove(int move, int symmetry){
+    return GetTables().moveConjugate[move][symmetry];
+}
+
+CubieCube Symmetry::Conjugate(const CubieCube& cube, int symmetry){
+    return GetTables().Conjugate(cube, symmetry);
+}
+
+CubieCube Symmetry::Canonical(const CubieCube& cube, int* symmetry, bool* inverted){
+    uint64_t cornerKey;
+    uint64_t edgeKey;
+    int bestSymmetry = 0;
+    bool bestInverted = false;
+    CanonicalKeys(cube, cornerKey, edgeKey, bestSymmetry, bestInverted);
+    if (symmetry != nullptr){
+        *symmetry = bestSymmetry;
+    }
+    if (inverted != nullptr){
+        *inverted = bestInverted;
+    }
+    return Conjugate(bestInverted ? cube.Inverse() : cube, bestSymmetry);
+}
+
+uint64_t Symmetry::CanonicalHash(const CubieCube& cube, int* symmetry, bool* inverted){
+    uint64_t cornerKey;
+    uint64_t edgeKey;
+    int bestSymmetry = 0;
+    bool bestInverted = false;
+    CanonicalKeys(cube, cornerKey, edgeKey, bestSymmetry, bestInverted);
+    if (symmetry != nullptr){
+        *symmetry = bestSymmetry;
+    }
+    if (inverted != nullptr){
+        *inverted = bestInverted;
+    }
+    // 40 + 60 bits of keys, mixed down to 64 (splitmix64 finalizer)
+    uint64_t hash = edgeKey ^ (cornerKey * 0x9E3779B97F4A7C15ull);
+    hash = (hash ^ (hash >> 30))*0xBF58476D1CE4E5B9ull;
+    hash = (hash ^ (hash >> 27))*0x94D049BB133111EBull;
+    return hash ^ (hash >> 31);
+}
+
+int Symmetry::CornerClass(int cornerPerm){
+    return GetTables().cornerClass[cornerPerm];
+}
+
+int Symmetry::CornerClassSymmetry(int cornerPerm){
+    return GetTables().cornerClassSymmetry[cornerPerm];
+}
+
+int Symmetry::CornerRepresentative(int cornerClass){
+    return GetTables().cornerRepresentative[cornerClass];
+}
+
+int Symmetry::CornerClassStabilizer(int cornerClass){
+    return GetTables().cornerStabilizer[cornerClass];
+}
+
+int Symmetry::ConjugateTwist(int twist, int symmetry){
+    return GetTables().twistConjugate[twist*NUM_UD_SYMMETRIES + symmetry];
+}
@@ -0,0 +1,478 @@
+#include "ThistlethwaiteSolver.hpp"
+#include "CubieCube.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+    // face turns each phase may use, as Move enum values (U R F D L B,
+    // each as quarter turn, half turn, inverse)
+    const int PHASE1_MOVES[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
+    const int PHASE2_MOVES[] = {0, 1, 2, 3, 4, 5, 7, 9, 10, 11, 12, 13, 14, 16};
+    const int PHASE3_MOVES[] = {0, 1, 2, 4, 7, 9, 10, 11, 13, 16};
+    const int PHASE4_MOVES[] = {1, 4, 7, 10, 13, 16};
+    const int* const PHASE_MOVES[ThistlethwaiteSolver::NUM_PHASES] = {PHASE1_MOVES, PHASE2_MOVES, PHASE3_MOVES, PHASE4_MOVES};
+    const int NUM_PHASE_MOVES[ThistlethwaiteSolver::NUM_PHASES] = {18, 14, 10, 6};
+
+    // coordinates the index of each phase is made of
+    const int NUM_FLIPS = 2048;
+    const int NUM_TWISTS = 2187;
+    const int NUM_SLICES = 495;         // 12 choose 4 positions of the middle layer edges
+    const int NUM_CORNER_PAIRS = 2520;  // 8!/2^4 ways to place four pairs of corners
+    const int NUM_M_SLICES = 70;        // 8 choose 4 positions of the M slice edges
+    const int NUM_SQUARE_CORNERS = 96;  // corner permutations of G3
+    const int NUM_ORBIT_PERMS = 24;     // orders of the four edges of a slice
+    // the E slice order only counts by halves, its parity follows from the rest
+    const int NUM_SQUARE_EDGES = NUM_ORBIT_PERMS*NUM_ORBIT_PERMS*NUM_ORBIT_PERMS/2;
+    const int PHASE_SIZE[ThistlethwaiteSolver::NUM_PHASES] = {
+        NUM_FLIPS, NUM_TWISTS*NUM_SLICES, NUM_CORNER_PAIRS*NUM_M_SLICES*2, NUM_SQUARE_CORNERS*NUM_SQUARE_EDGES
+    };
+
+    // middle layer edges (FR FL BL BR) are the last four
+    const int FIRST_SLICE_EDGE = 8;
+    // positions that only swap among themselves under half turns
+    const int TETRAD_A[4] = {0, 2, 5, 7};
+    const int TETRAD_B[4] = {1, 3, 4, 6};
+    const int M_SLICE[4] = {1, 3, 5, 7};
+    const int S_SLICE[4] = {0, 2, 4, 6};
+    const int E_SLICE[4] = {8, 9, 10, 11};
+
+    // c followed by a face turn, CubieCube::Multiply without mirrored corners
+    CubieCube Turn(const CubieCube& c, int move){
+        const CubieCube& turn = CubieCube::FaceMove(move);
+        CubieCube result;
+        for (int i=0; i<CubeState::NUM_CORNERS; i++){
+            result.cp[i] = c.cp[turn.cp[i]];
+            int twist = c.co[turn.cp[i]] + turn.co[i];
+            result.co[i] = twist >= 3 ? twist - 3 : twist;
+        }
+        for (int i=0; i<CubeState::NUM_EDGES; i++){
+            result.ep[i] = c.ep[turn.ep[i]];
+            result.eo[i] = c.eo[turn.ep[i]] ^ turn.eo[i];
+        }
+        return result;
+    }
+
+    // rank of the set bits of a mask among masks with as many bits, colex order
+    int CombinationRank(int mask){
+        int rank = 0;
+        int count = 0;
+        for (int position=0; (mask >> position) != 0; position++){
+            if (mask & (1 << position)){
+                count++;
+                rank += CubieCube::Choose(position, count);
+            }
+        }
+        return rank;
+    }
+
+    int CombinationMask(int rank, int n, int k){
+        int mask = 0;
+        for (int position=n-1; k > 0; position--){
+            int count = CubieCube::Choose(position, k);
+            if (rank >= count){
+                rank -= count;
+                mask |= 1 << position;
+                k--;
+            }
+        }
+        return mask;
+    }
+
+    int Parity(const uint8_t* values, int n){
+        int parity = 0;
+        for (int i=0; i<n; i++){
+            for (int j=i+1; j<n; j++){
+                parity ^= values[j] < values[i];
+            }
+        }
+        return parity;
+    }
+
+    // * each coordinate read from cubies, and set on a solved cube
+
+    int Slice(const CubieCube& c){
+        int mask = 0;
+        for (int i=0; i<CubeState::NUM_EDGES; i++){
+            mask |= (c.ep[i] >= FIRST_SLICE_EDGE) << i;
+        }
+        return CombinationRank(mask);
+    }
+
+    void SetSlice(CubieCube& c, int slice){
+        int mask = CombinationMask(slice, CubeState::NUM_EDGES, 4);
+        int sliceEdge = FIRST_SLICE_EDGE;
+        int otherEdge = 0;
+        for (int i=0; i<CubeState::NUM_EDGES; i++){
+            c.ep[i] = (mask & (1 << i)) ? sliceEdge++ : otherEdge++;
+        }
+    }
+
+    // the diagonal pair of its face a corner belongs to: URF ULB, UFL UBR, DFR DBL, DLF DRB
+    int CornerPair(int piece){
+        return (piece >= 4)*2 + (piece & 1);
+    }
+
+    // positions of pairs 0, 1 and 2 among the positions left, pair 3 gets the rest
+    int CornerPairs(const CubieCube& c){
+        int rank = 0;
+        int left = 0xFF;
+        for (int pair=0; pair<3; pair++){
+            int mask = 0;
+            int count = 0;
+            for (int i=0; i<CubeState::NUM_CORNERS; i++){
+                if (left & (1 << i)){
+                    if (CornerPair(c.cp[i]) == pair){
+                        mask |= 1 << count;
+                        left &= ~(1 << i);
+                    }
+                    count++;
+                }
+            }
+            rank = rank*CubieCube::Choose(count, 2) + CombinationRank(mask);
+        }
+        return rank;
+    }
+
+    void SetCornerPairs(CubieCube& c, int pairs){
+        int ranks[3] = {pairs / 90, pairs / 6 % 15, pairs % 6};
+        // next piece of each pair
+        int next[4] = {0, 1, 4, 5};
+        int left = 0xFF;
+        for (int pair=0; pair<3; pair++){
+            int mask = CombinationMask(ranks[pair], __builtin_popcount(left), 2);
+            int count = 0;
+            int taken = 0;
+            for (int i=0; i<CubeState::NUM_CORNERS; i++){
+                if (left & (1 << i)){
+                    if (mask & (1 << count)){
+                        c.cp[i] = next[pair];
+                        next[pair] += 2;
+                        taken |= 1 << i;
+                    }
+                    count++;
+                }
+            }
+            left &= ~taken;
+        }
+        for (int i=0; i<CubeState::NUM_CORNERS; i++){
+            if (left & (1 << i)){
+                c.cp[i] = next[3];
+                next[3] += 2;
+            }
+        }
+    }
+
+    // which U and D layer edge positions hold M slice edges (UF UB DF DB)
+    int MSlice(const CubieCube& c){
+        int mask = 0;
+        for (int i=0; i<FIRST_SLICE_EDGE; i++){
+            mask |= (c.ep[i] & 1) << i;
+        }
+        return CombinationRank(mask);
+    }
+
+    void SetMSlice(CubieCube& c, int mSlice){
+        int mask = CombinationMask(mSlice, FIRST_SLICE_EDGE, 4);
+        int mEdge = 1;
+        int sEdge = 0;
+        for (int i=0; i<FIRST_SLICE_EDGE; i++){
+            if (mask & (1 << i)){
+                c.ep[i] = mEdge;
+                mEdge += 2;
+            } else {
+                c.ep[i] = sEdge;
+                sEdge += 2;
+            }
+        }
+    }
+
+    // rank of the pieces at four positions that hold each other's pieces
+    int OrbitPerm(const uint8_t* pieces, const int* positions){
+        uint8_t values[4];
+        for (int i=0; i<4; i++){
+            values[i] = std::find(positions, positions + 4, pieces[positions[i]]) - positions;
+        }
+        return CubieCube::PermIndex(values, 4);
+    }
+
+    void SetOrbitPerm(uint8_t* pieces, const int* positions, int rank){
+        uint8_t values[4];
+        CubieCube::SetPerm(values, 4, rank, 0);
+        for (int i=0; i<4; i++){
+            pieces[positions[i]] = positions[values[i]];
+        }
+    }
+
+    // the coordinate after each move of a phase, for every value of it
+    template<typename Set, typename Get>
+    std::vector<uint16_t> MoveTable(int phase, int size, Set set, Get get){
+        int moves = NUM_PHASE_MOVES[phase];
+        std::vector<uint16_t> table(size*moves);
+        for (int i=0; i<size; i++){
+            CubieCube c = CubieCube::Solved();
+            set(c, i);
+            for (int m=0; m<moves; m++){
+                table[i*moves + m] = get(Turn(c, PHASE_MOVES[phase][m]));
+            }
+        }
+        return table;
+    }
+
+    // move and distance tables, shared by every solver
+    struct Tables{
+        // phase 1: edge orientation
+        std::vector<uint16_t> flipMove;
+        // phase 2: corner orientation, middle layer edge positions
+        std::vector<uint16_t> twistMove;
+        std::vector<uint16_t> sliceMove;
+        // phase 3: corner pairs, M slice edge positions, and corner parity,
+        // which the quarter turns flip
+        std::vector<uint16_t> cornerPairsMove;
+        std::vector<uint16_t> mSliceMove;
+        uint8_t moveParity[CubeState::NUM_FACE_MOVES];
+        // phase 4: G3 corner permutations, numbered from tetrad permutations
+        // (24*24) and back, and the edge order within each slice
+        int16_t squareCorner[24*24];
+        uint16_t squareCornerCode[NUM_SQUARE_CORNERS];
+        uint8_t squareCornerParity[NUM_SQUARE_CORNERS];
+        std::vector<uint16_t> squareCornerMove;
+        std::vector<uint16_t> orbitMove[3];
+        uint8_t orbitParity[NUM_ORBIT_PERMS];
+
+        // distance mod 3 of every index of a phase, four to a byte,
+        // 3 for indices that can not be reached
+        std::vector<uint8_t> distance[ThistlethwaiteSolver::NUM_PHASES];
+        // index of the solved cube in each phase
+        int goal[ThistlethwaiteSolver::NUM_PHASES];
+
+        Tables();
+        // index of a cube in the group a phase starts from
+        int Index(int phase, const CubieCube& c) const;
+        // index after the m-th move of a phase
+        int Move(int phase, int index, int m) const;
+        int Distance(int phase, int index) const{
+            return (distance[phase][index >> 2] >> ((index & 3)*2)) & 3;
+        }
+        void Generate(int phase);
+        size_t Bytes() const;
+    };
+
+    Tables::Tables(){
+        flipMove = MoveTable(0, NUM_FLIPS,
+            [](CubieCube& c, int flip){ c.SetFlip(flip); }, [](const CubieCube& c){ return c.Flip(); });
+        twistMove = MoveTable(1, NUM_TWISTS,
+            [](CubieCube& c, int twist){ c.SetTwist(twist); }, [](const CubieCube& c){ return c.Twist(); });
+        sliceMove = MoveTable(1, NUM_SLICES, SetSlice, Slice);
+        cornerPairsMove = MoveTable(2, NUM_CORNER_PAIRS, SetCornerPairs, CornerPairs);
+        mSliceMove = MoveTable(2, NUM_M_SLICES, SetMSlice, MSlice);
+        for (int m=0; m<NUM_PHASE_MOVES[2]; m++){
+            moveParity[m] = Parity(CubieCube::FaceMove(PHASE3_MOVES[m]).cp, CubeState::NUM_CORNERS);
+        }
+
+        // the corner permutations of G3 are the ones half turns reach
+        std::fill(squareCorner, squareCorner + 24*24, -1);
+        std::vector<CubieCube> found(1, CubieCube::Solved());
+        squareCorner[0] = 0;
+        squareCornerCode[0] = 0;
+        for (size_t i=0; i<found.size(); i++){
+            squareCornerParity[i] = Parity(found[i].cp, CubeState::NUM_CORNERS);
+            for (int m : PHASE4_MOVES){
+                CubieCube next = Turn(found[i], m);
+                int code = OrbitPerm(next.cp, TETRAD_A)*24 + OrbitPerm(next.cp, TETRAD_B);
+                if (squareCorner[code] < 0){
+                    squareCorner[code] = found.size();
+                    squareCornerCode[found.size()] = code;
+                    found.push_back(next);
+                }
+            }
+        }
+        squareCornerMove = MoveTable(3, NUM_SQUARE_CORNERS,
+            [this](CubieCube& c, int corners){
+                SetOrbitPerm(c.cp, TETRAD_A, squareCornerCode[corners] / 24);
+                SetOrbitPerm(c.cp, TETRAD_B, squareCornerCode[corners] % 24);
+            },
+            [this](const CubieCube& c){ return squareCorner[OrbitPerm(c.cp, TETRAD_A)*24 + OrbitPerm(c.cp, TETRAD_B)]; });
+        const int* const slices[3] = {M_SLICE, S_SLICE, E_SLICE};
+        for (int slice=0; slice<3; slice++){
+            const int* positions = slices[slice];
+            orbitMove[slice] = MoveTable(3, NUM_ORBIT_PERMS,
+                [positions](CubieCube& c, int perm){ SetOrbitPerm(c.ep, positions, perm); },
+                [positions](const CubieCube& c){ return OrbitPerm(c.ep, positions); });
+        }
+        for (int perm=0; perm<NUM_ORBIT_PERMS; perm++){
+            uint8_t values[4];
+            CubieCube::SetPerm(values, 4, perm, 0);
+            orbitParity[perm] = Parity(values, 4);
+        }
+
+        for (int phase=0; phase<ThistlethwaiteSolver::NUM_PHASES; phase++){
+            goal[phase] = Index(phase, CubieCube::Solved());
+            Generate(phase);
+        }
+    }
+
+    int Tables::Index(int phase, const CubieCube& c) const{
+        switch (phase){
+            case 0:
+                return c.Flip();
+            case 1:
+                return c.Twist()*NUM_SLICES + Slice(c);
+            case 2:
+                return (CornerPairs(c)*NUM_M_SLICES + MSlice(c))*2 + Parity(c.cp, CubeState::NUM_CORNERS);
+            default: {
+                int corners = squareCorner[OrbitPerm(c.cp, TETRAD_A)*24 + OrbitPerm(c.cp, TETRAD_B)];
+                int edges = (OrbitPerm(c.ep, M_SLICE)*NUM_ORBIT_PERMS + OrbitPerm(c.ep, S_SLICE))*NUM_ORBIT_PERMS/2
+                          + OrbitPerm(c.ep, E_SLICE)/2;
+                return corners*NUM_SQUARE_EDGES + edges;
+            }
+        }
+    }
+
+    int Tables::Move(int phase, int index, int m) const{
+        int moves = NUM_PHASE_MOVES[phase];
+        switch (phase){
+            case 0:
+                return flipMove[index*moves + m];
+            case 1:
+                return twistMove[index / NUM_SLICES*moves + m]*NUM_SLICES + sliceMove[index % NUM_SLICES*moves + m];
+            case 2: {
+                int pairs = cornerPairsMove[index / (NUM_M_SLICES*2)*moves + m];
+                int mSlice = mSliceMove[index / 2 % NUM_M_SLICES*moves + m];
+                return (pairs*NUM_M_SLICES + mSlice)*2 + ((index & 1) ^ moveParity[m]);
+            }
+            default: {
+                int corners = index / NUM_SQUARE_EDGES;
+                int mPerm = index / (NUM_ORBIT_PERMS*NUM_ORBIT_PERMS/2) % NUM_ORBIT_PERMS;
+                int sPerm = index / (NUM_ORBIT_PERMS/2) % NUM_ORBIT_PERMS;
+                // edge and corner parity agree, and of the E slice orders
+                // 2k and 2k+1 one is odd and one even
+                int ePerm = index % (NUM_ORBIT_PERMS/2)*2;
+                ePerm += orbitParity[ePerm] ^ squareCornerParity[corners] ^ orbitParity[mPerm] ^ orbitParity[sPerm];
+                corners = squareCornerMove[corners*moves + m];
+                mPerm = orbitMove[0][mPerm*moves + m];
+                sPerm = orbitMove[1][sPerm*moves + m];
+                ePerm = orbitMove[2][ePerm*moves + m];
+                return corners*NUM_SQUARE_EDGES + (mPerm*NUM_ORBIT_PERMS + sPerm)*NUM_ORBIT_PERMS/2 + ePerm/2;
+            }
+        }
+    }
+
+    // breadth first search from the solved cube over the moves of the phase
+    void Tables::Generate(int phase){
+        int size = PHASE_SIZE[phase];
+        std::vector<uint8_t> depths(size, 0xFF);
+        std::vector<int> frontier(1, goal[phase]);
+        depths[goal[phase]] = 0;
+        for (int depth=0; !frontier.empty(); depth++){
+            std::vector<int> next;
+            for (int index : frontier){
+                for (int m=0; m<NUM_PHASE_MOVES[phase]; m++){
+                    int moved = Move(phase, index, m);
+                    if (depths[moved] == 0xFF){
+                        depths[moved] = depth + 1;
+                        next.push_back(moved);
+                    }
+                }
+            }
+            frontier.swap(next);
+        }
+        distance[phase].assign((size + 3)/4, 0);
+        for (int i=0; i<size; i++){
+            int value = depths[i] == 0xFF ? 3 : depths[i] % 3;
+            distance[phase][i >> 2] |= value << ((i & 3)*2);
+        }
+    }
+
+    size_t Tables::Bytes() const{
+        size_t bytes = sizeof(moveParity) + sizeof(squareCorner) + sizeof(squareCornerCode)
+                     + sizeof(squareCornerParity) + sizeof(orbitParity);
+        const std::vector<uint16_t>* moveTables[] = {
+            &flipMove, &twistMove, &sliceMove, &cornerPairsMove, &mSliceMove,
+            &squareCornerMove, &orbitMove[0], &orbitMove[1], &orbitMove[2]
+        };
+        for (const std::vector<uint16_t>* table : moveTables){
+            bytes += table->size()*sizeof(uint16_t);
+        }
+        for (int phase=0; phase<ThistlethwaiteSolver::NUM_PHASES; phase++){
+            bytes += distance[phase].size();
+        }
+        return bytes;
+    }
+
+    const Tables& GetTables(){
+        static const Tables TABLES;
+        return TABLES;
+    }
+
+    // add a face turn, merged with the one before it if it turns the same face
+    void AppendMove(std::vector<Move>& solution, size_t firstTurn, int move){
+        if (solution.size() > firstTurn && static_cast<int>(solution.back())/3 == move/3){
+            int previous = static_cast<int>(solution.back());
+            int turns = (previous % 3 + 1 + move % 3 + 1) % 4;
+            solution.pop_back();
+            if (turns != 0){
+                solution.push_back(static_cast<Move>(move - move % 3 + turns - 1));
+            }
+            return;
+        }
+        solution.push_back(static_cast<Move>(move));
+    }
+}
+
+ThistlethwaiteSolver::ThistlethwaiteSolver(){
+    GetTables();
+}
+
+bool ThistlethwaiteSolver::Solve(const CubeState& state, std::vector<Move>& solution) const{
+    solution.clear();
+    std::vector<Move> rotations;
+    if (!CubieCube::FindCenterRotations(state, rotations)){
+        return false;
+    }
+    CubeState rotated = state;
+    for (Move rotation : rotations){
+        rotated.ApplyMove(rotation);
+    }
+    CubieCube c = CubieCube::FromState(rotated);
+    if (!c.IsSolvable()){
+        return false;
+    }
+
+    const Tables& tables = GetTables();
+    solution = rotations;
+    int phaseMoves[MAX_LENGTH];
+    for (int phase=0; phase<NUM_PHASES; phase++){
+        // the cubies are only needed to start each phase, in between
+        // the index moves by itself
+        int index = tables.Index(phase, c);
+        int length = 0;
+        while (index != tables.goal[phase]){
+            // neighbors are one closer, as close, or one further, so the
+            // one closer is the one whose distance is one less mod 3
+            int closer = (tables.Distance(phase, index) + 2) % 3;
+            int m = 0;
+            int next = 0;
+            for (; m<NUM_PHASE_MOVES[phase]; m++){
+                next = tables.Move(phase, index, m);
+                if (tables.Distance(phase, next) == closer){
+                    break;
+                }
+            }
+            if (m == NUM_PHASE_MOVES[phase] || length == MAX_LENGTH){
+                return false;
+            }
+            index = next;
+            phaseMoves[length++] = PHASE_MOVES[phase][m];
+            AppendMove(solution, rotations.size(), PHASE_MOVES[phase][m]);
+        }
+        for (int i=0; i<length; i++){
+            c = Turn(c, phaseMoves[i]);
+        }
+    }
+    return true;
+}
+
+size_t ThistlethwaiteSolver::MemoryFootprint(){
+    return GetTables().Bytes();
+}
@@ -1,11 +1,13 @@
 #include "Transform.hpp"
+#include "RotationGroup.hpp"
+#include <cmath>
 #include <iostream>
-#include <glm/gtx/rotate_vector.hpp>
 
 // By default, all transform matrices
 // are also identity matrices
 Transform::Transform(){
     LoadIdentity();
+    identityRotation = RotationGroup::IDENTITY;
 }
 
 Transform::~Transform(){
@@ -97,38 +99,33 @@ Transform operator+(const Transform& lhs, const Transform& rhs){
 }
 
 void Transform::UpdateIdentityRotation(RotationType rotationType, float radians){
-    appliedRotations.push_back(std::make_pair(rotationType, radians));
+    int axis;
+    switch(rotationType){
+        case RotationType::YAW:
+            axis = 0;
+            break;
+        case RotationType::PITCH:
+            axis = 1;
+            break;
+        case RotationType::ROLL:
+            axis = 2;
+            break;
+        default:
+            return;
+    }
+    // turns are around the absolute axes, so the new turn goes on the left
+    int turns = static_cast<int>(std::lround(radians / M_PI_2));
+    identityRotation = RotationGroup::Compose(RotationGroup::QuarterTurn(axis, turns), identityRotation);
 }
 
 void Transform::ApplyIdentityRotation() {
-    // ** axes are not absolute, they're relative to the model - need norms**
-    glm::vec3 xNorm(1.0, 0.0f, 0.0);
-    glm::vec3 yNorm(0.0, 1.0f, 0.0);
-    glm::vec3 zNorm(0.0, 0.0f, 1.0);
-
-    // important: rotations are not commutative, so store and apply them sequentially
-    for (std::pair<RotationType, float> rotation : appliedRotations){
-        switch(rotation.first){
-            case RotationType::NONE:
-                break;
-            case RotationType::YAW:
-                // rotate around x axis and update other norms
-                m_modelTransformMatrix = glm::rotate(m_modelTransformMatrix, rotation.second, xNorm);
-                yNorm = glm::rotate(yNorm, -rotation.second, xNorm);
-                zNorm = glm::rotate(zNorm, -rotation.second, xNorm);
-                break;
-            case RotationType::PITCH:
-                // rotate around y axis and update other norms
-                m_modelTransformMatrix = glm::rotate(m_modelTransformMatrix, rotation.second, yNorm);
-                xNorm = glm::rotate(xNorm, -rotation.second, yNorm);
-                zNorm = glm::rotate(zNorm, -rotation.second, yNorm);
-                break;
-            case RotationType::ROLL:
-                // rotate around z axis and update other norms
-                m_modelTransformMatrix = m_modelTransformMatrix = glm::rotate(m_modelTransformMatrix, rotation.second, zNorm);
-                xNorm = glm::rotate(xNorm, -rotation.second, zNorm);
-                yNorm = glm::rotate(yNorm, -rotation.second, zNorm);
-                break;
+    // exact integer rotation, glm matrices are column major
+    const RotationGroup::Matrix& rotation = RotationGroup::GetMatrix(identityRotation);
+    glm::mat4 matrix(1.0f);
+    for (int row=0; row<3; row++){
+        for (int col=0; col<3; col++){
+            matrix[col][row] = static_cast<float>(rotation.m[row][col]);
         }
     }
-}
\ No newline at end of file
+    m_modelTransformMatrix = m_modelTransformMatrix * matrix;
+}
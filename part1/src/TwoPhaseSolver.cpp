@@ -0,0 +1,314 @@
+#include "TwoPhaseSolver.hpp"
+#include "CubieCube.hpp"
+#include "MoveTables.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    // face turns in phase 2, as Move enum values: U U2 U' D D2 D' R2 L2 F2 B2
+    const int PHASE2_MOVES[TwoPhaseSolver::NUM_PHASE2_MOVES] = {0, 1, 2, 9, 10, 11, 4, 13, 7, 16};
+    // middle layer edges (FR FL BL BR) are the last four
+    const int FIRST_SLICE_EDGE = 8;
+    // every phase 2 position can be solved in 18 moves
+    const int MAX_PHASE2_LENGTH = 18;
+
+    // * coordinates only the two-phase search needs, 0 for the solved cube
+    // which four positions hold the middle layer edges, in any order
+    int Slice(const CubieCube& c){
+        int slice = 0;
+        int found = 0;
+        for (int j=CubeState::NUM_EDGES-1; j>=0; j--){
+            if (c.ep[j] >= FIRST_SLICE_EDGE){
+                slice += CubieCube::Choose(CubeState::NUM_EDGES-1-j, found+1);
+                found++;
+            }
+        }
+        return slice;
+    }
+
+    void SetSlice(CubieCube& c, int slice){
+        int left = 4;
+        int sliceEdge = FIRST_SLICE_EDGE;
+        int otherEdge = 0;
+        for (int j=0; j<CubeState::NUM_EDGES; j++){
+            int count = CubieCube::Choose(CubeState::NUM_EDGES-1-j, left);
+            if (left > 0 && slice - count >= 0){
+                c.ep[j] = sliceEdge++;
+                slice -= count;
+                left--;
+            } else {
+                c.ep[j] = otherEdge++;
+            }
+        }
+    }
+
+    // only valid in phase 2, where the U and D edges stay in the U and D layers
+    int UdEdgePerm(const CubieCube& c){
+        return CubieCube::PermIndex(c.ep, FIRST_SLICE_EDGE);
+    }
+
+    int SlicePerm(const CubieCube& c){
+        uint8_t values[4];
+        for (int i=0; i<4; i++){
+            values[i] = c.ep[FIRST_SLICE_EDGE+i] - FIRST_SLICE_EDGE;
+        }
+        return CubieCube::PermIndex(values, 4);
+    }
+
+    // coordinate move table, set(c, i) builds a cube for coordinate i
+    template<typename Set, typename Get>
+    std::vector<uint16_t> BuildMoveTable(int size, const int* moves, int numMoves, Set set, Get get){
+        std::vector<uint16_t> table(size*numMoves);
+        for (int i=0; i<size; i++){
+            CubieCube c = CubieCube::Solved();
+            set(c, i);
+            for (int m=0; m<numMoves; m++){
+                table[i*numMoves + m] = get(c.Multiply(CubieCube::FaceMove(moves[m])));
+            }
+        }
+        return table;
+    }
+
+    // breadth first search from the goal over pairs of coordinates, where
+    // a is moved with tableA and b with tableB, both numMoves wide
+    std::vector<int8_t> BuildPruneTable(int sizeA, int sizeB, int numMoves,
+                                        const std::vector<uint16_t>& tableA, int widthA, const int* columnsA,
+                                        const std::vector<uint16_t>& tableB){
+        std::vector<int8_t> table(sizeA*sizeB, -1);
+        std::vector<uint32_t> frontier(1, 0);
+        std::vector<uint32_t> next;
+        table[0] = 0;
+        for (int depth=0; !frontier.empty(); depth++){
+            next.clear();
+            for (uint32_t index : frontier){
+                int a = index / sizeB;
+                int b = index % sizeB;
+                for (int m=0; m<numMoves; m++){
+                    uint32_t moved = tableA[a*widthA + columnsA[m]]*sizeB + tableB[b*numMoves + m];
+                    if (table[moved] < 0){
+                        table[moved] = depth+1;
+                        next.push_back(moved);
+                    }
+                }
+            }
+            frontier.swap(next);
+        }
+        return table;
+    }
+
+    bool IsPhase2Move(int move){
+        return std::find(PHASE2_MOVES, PHASE2_MOVES + TwoPhaseSolver::NUM_PHASE2_MOVES, move)
+            != PHASE2_MOVES + TwoPhaseSolver::NUM_PHASE2_MOVES;
+    }
+}
+
+struct TwoPhaseSolver::Search{
+    CubieCube start;
+    int moves[MAX_LENGTH];
+    int bestLength;
+    std::vector<Move> best;
+    int targetLength;
+    std::chrono::steady_clock::time_point deadline;
+    // rotations in front of every solution handed to progress
+    std::vector<Move> rotations;
+    const Progress* progress;
+    const std::atomic<bool>* stop;
+    // phase 1 nodes also time the search, phase 2 ones are kept apart
+    long long nodes;
+    long long phase2Nodes;
+    bool done;
+
+    bool Stopped() const{
+        return stop != nullptr && stop->load(std::memory_order_relaxed);
+    }
+};
+
+TwoPhaseSolver::TwoPhaseSolver(){
+    int faceMoves[CubeState::NUM_FACE_MOVES];
+    for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+        faceMoves[m] = m;
+    }
+    int phase2Columns[NUM_PHASE2_MOVES];
+    for (int m=0; m<NUM_PHASE2_MOVES; m++){
+        phase2Columns[m] = m;
+    }
+
+    m_twistMove = BuildMoveTable(NUM_TWISTS, faceMoves, CubeState::NUM_FACE_MOVES, 
+        [](CubieCube& c, int i){ c.SetTwist(i); }, [](const CubieCube& c){ return c.Twist(); });
+    m_flipMove = BuildMoveTable(NUM_FLIPS, faceMoves, CubeState::NUM_FACE_MOVES, 
+        [](CubieCube& c, int i){ c.SetFlip(i); }, [](const CubieCube& c){ return c.Flip(); });
+    m_sliceMove = BuildMoveTable(NUM_SLICES, faceMoves, CubeState::NUM_FACE_MOVES, SetSlice, Slice);
+    m_cornerPermMove = BuildMoveTable(NUM_CORNER_PERMS, faceMoves, CubeState::NUM_FACE_MOVES,
+        [](CubieCube& c, int i){ c.SetCornerPerm(i); }, [](const CubieCube& c){ return c.CornerPerm(); });
+    m_udEdgePermMove = BuildMoveTable(NUM_UD_EDGE_PERMS, PHASE2_MOVES, NUM_PHASE2_MOVES,
+        [](CubieCube& c, int i){ CubieCube::SetPerm(c.ep, FIRST_SLICE_EDGE, i, 0); }, UdEdgePerm);
+    m_slicePermMove = BuildMoveTable(NUM_SLICE_PERMS, PHASE2_MOVES, NUM_PHASE2_MOVES,
+        [](CubieCube& c, int i){ CubieCube::SetPerm(c.ep + FIRST_SLICE_EDGE, 4, i, FIRST_SLICE_EDGE); }, SlicePerm);
+
+    m_twistSlicePrune = BuildPruneTable(NUM_TWISTS, NUM_SLICES, CubeState::NUM_FACE_MOVES,
+        m_twistMove, CubeState::NUM_FACE_MOVES, faceMoves, m_sliceMove);
+    m_flipSlicePrune = BuildPruneTable(NUM_FLIPS, NUM_SLICES, CubeState::NUM_FACE_MOVES,
+        m_flipMove, CubeState::NUM_FACE_MOVES, faceMoves, m_sliceMove);
+    m_cornerSlicePermPrune = BuildPruneTable(NUM_CORNER_PERMS, NUM_SLICE_PERMS, NUM_PHASE2_MOVES,
+        m_cornerPermMove, CubeState::NUM_FACE_MOVES, PHASE2_MOVES, m_slicePermMove);
+    m_edgeSlicePermPrune = BuildPruneTable(NUM_UD_EDGE_PERMS, NUM_SLICE_PERMS, NUM_PHASE2_MOVES,
+        m_udEdgePermMove, NUM_PHASE2_MOVES, phase2Columns, m_slicePermMove);
+}
+
+bool TwoPhaseSolver::Solve(const CubeState& state, std::vector<Move>& solution,
+                           int targetLength, double maxSeconds, long long* nodes,
+                           const Progress& progress, const std::atomic<bool>* stop) const{
+    solution.clear();
+    std::vector<Move> rotations;
+    if (!CubieCube::FindCenterRotations(state, rotations)){
+        return false;
+    }
+    CubeState rotated = state;
+    for (Move rotation : rotations){
+        rotated.ApplyMove(rotation);
+    }
+
+    Search search;
+    search.start = CubieCube::FromState(rotated);
+    if (!search.start.IsSolvable()){
+        return false;
+    }
+    search.bestLength = MAX_LENGTH;
+    search.targetLength = targetLength;
+    search.deadline = std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(maxSeconds));
+    search.rotations = rotations;
+    search.progress = progress ? &progress : nullptr;
+    search.stop = stop;
+    search.nodes = 0;
+    search.phase2Nodes = 0;
+    search.done = false;
+
+    // deepen phase 1, every phase 1 solution is finished by phase 2
+    int twist = search.start.Twist();
+    int flip = search.start.Flip();
+    int slice = Slice(search.start);
+    for (int depth=0; depth<search.bestLength && !search.done; depth++){
+        Phase1(search, twist, flip, slice, 0, depth);
+    }
+
+    if (nodes != nullptr){
+        *nodes = search.nodes + search.phase2Nodes;
+    }
+    // only a stopped search ends without a solution
+    if (search.bestLength == MAX_LENGTH){
+        return false;
+    }
+    solution = rotations;
+    solution.insert(solution.end(), search.best.begin(), search.best.end());
+    return true;
+}
+
+bool TwoPhaseSolver::Phase1(Search& search, int twist, int flip, int slice, int depth, int togo) const{
+    if (togo == 0){
+        // a phase 1 solution ending in a phase 2 move was already tried one move shorter
+        bool inSubgroup = twist == 0 && flip == 0 && slice == 0;
+        if (inSubgroup && (depth == 0 || !IsPhase2Move(search.moves[depth-1]))){
+            StartPhase2(search, depth);
+        }
+        return search.done;
+    }
+
+    // give up on finding a shorter solution once time is up, or at once
+    // when asked to stop
+    if ((++search.nodes & 1023) == 0 && (search.Stopped() || (search.bestLength < MAX_LENGTH
+        && std::chrono::steady_clock::now() > search.deadline))){
+        search.done = true;
+        return true;
+    }
+
+    int previous = depth > 0 ? search.moves[depth-1] : -1;
+    for (int m=0; m<CubeState::NUM_FACE_MOVES; m++){
+        if (MoveTables::RedundantFaceTurn(m, previous)){
+            continue;
+        }
+        int newTwist = m_twistMove[twist*CubeState::NUM_FACE_MOVES + m];
+        int newFlip = m_flipMove[flip*CubeState::NUM_FACE_MOVES + m];
+        int newSlice = m_sliceMove[slice*CubeState::NUM_FACE_MOVES + m];
+        int estimate = std::max(m_twistSlicePrune[newTwist*NUM_SLICES + newSlice],
+                                m_flipSlicePrune[newFlip*NUM_SLICES + newSlice]);
+        if (estimate > togo-1){
+            continue;
+        }
+        search.moves[depth] = m;
+        if (Phase1(search, newTwist, newFlip, newSlice, depth+1, togo-1)){
+            return true;
+        }
+    }
+    return false;
+}
+
+void TwoPhaseSolver::StartPhase2(Search& search, int length1) const{
+    // phase 2 coordinates are only defined once phase 1 is done
+    CubieCube c = search.start;
+    for (int i=0; i<length1; i++){
+        c = c.Multiply(CubieCube::FaceMove(search.moves[i]));
+    }
+    int cornerPerm = c.CornerPerm();
+    int udEdgePerm = UdEdgePerm(c);
+    int slicePerm = SlicePerm(c);
+    int estimate = std::max(m_cornerSlicePermPrune[cornerPerm*NUM_SLICE_PERMS + slicePerm],
+                            m_edgeSlicePermPrune[udEdgePerm*NUM_SLICE_PERMS + slicePerm]);
+
+    for (int togo=estimate; togo <= MAX_PHASE2_LENGTH && length1+togo < search.bestLength && !search.done; togo++){
+        if (Phase2(search, cornerPerm, udEdgePerm, slicePerm, length1, togo)){
+            search.bestLength = length1 + togo;
+            search.best.clear();
+            for (int i=0; i<search.bestLength; i++){
+                search.best.push_back(static_cast<Move>(search.moves[i]));
+            }
+            search.done = search.bestLength <= search.targetLength;
+            if (search.progress != nullptr){
+                std::vector<Move> solution = search.rotations;
+                solution.insert(solution.end(), search.best.begin(), search.best.end());
+                (*search.progress)(solution);
+            }
+            return;
+        }
+    }
+}
+
+bool TwoPhaseSolver::Phase2(Search& search, int cornerPerm, int udEdgePerm, int slicePerm, int depth, int togo) const{
+    if ((++search.phase2Nodes & 1023) == 0 && search.Stopped()){
+        search.done = true;
+    }
+    if (search.done){
+        return false;
+    }
+    if (togo == 0){
+        return cornerPerm == 0 && udEdgePerm == 0 && slicePerm == 0;
+    }
+    int previous = depth > 0 ? search.moves[depth-1] : -1;
+    for (int i=0; i<NUM_PHASE2_MOVES; i++){
+        int m = PHASE2_MOVES[i];
+        if (MoveTables::RedundantFaceTurn(m, previous)){
+            continue;
+        }
+        int newCornerPerm = m_cornerPermMove[cornerPerm*CubeState::NUM_FACE_MOVES + m];
+        int newUdEdgePerm = m_udEdgePermMove[udEdgePerm*NUM_PHASE2_MOVES + i];
+        int newSlicePerm = m_slicePermMove[slicePerm*NUM_PHASE2_MOVES + i];
+        int estimate = std::max(m_cornerSlicePermPrune[newCornerPerm*NUM_SLICE_PERMS + newSlicePerm],
+                                m_edgeSlicePermPrune[newUdEdgePerm*NUM_SLICE_PERMS + newSlicePerm]);
+        if (estimate > togo-1){
+            continue;
+        }
+        search.moves[depth] = m;
+        if (Phase2(search, newCornerPerm, newUdEdgePerm, newSlicePerm, depth+1, togo-1)){
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t TwoPhaseSolver::MemoryFootprint() const{
+    return (m_twistMove.size() + m_flipMove.size() + m_sliceMove.size() + m_cornerPermMove.size()
+          + m_udEdgePermMove.size() + m_slicePermMove.size())*sizeof(uint16_t)
+         + m_twistSlicePrune.size() + m_flipSlicePrune.size()
+         + m_cornerSlicePermPrune.size() + m_edgeSlicePermPrune.size();
+}
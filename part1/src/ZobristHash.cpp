@@ -0,0 +1,28 @@
+#include "ZobristHash.hpp"
+
+uint64_t ZobristHash::Compute(const CubeState& state){
+    const uint8_t* bytes = state.Data();
+    uint64_t hash = 0;
+    for (int i=0; i<CubeState::PACKED_SIZE; i++){
+        hash ^= TABLES.keys[i][bytes[i]];
+    }
+    return hash;
+}
+
+uint64_t ZobristHash::ApplyMove(CubeState& state, uint64_t hash, Move move){
+    const ChangedBytes& changed = TABLES.changed[static_cast<int>(move)];
+    const uint8_t* bytes = state.Data();
+
+    // XOR out the keys of the bytes the move is about to change
+    for (int i=0; i<changed.count; i++){
+        int position = changed.positions[i];
+        hash ^= TABLES.keys[position][bytes[position]];
+    }
+    state.ApplyMove(move);
+    // and XOR in their new values
+    for (int i=0; i<changed.count; i++){
+        int position = changed.positions[i];
+        hash ^= TABLES.keys[position][bytes[position]];
+    }
+    return hash;
+}
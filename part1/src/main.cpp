@@ -1,17 +1,21 @@
-// Support Code written by Michael D. Shah
-// Last Updated: 1/21/17
-// Please do not redistribute without asking permission.
-
-// Functionality that we created
-#include "SDLGraphicsProgram.hpp"
-
-int main(int argc, char** argv){
-
-	// Create an instance of an object for a SDLGraphicsProgram
-	SDLGraphicsProgram mySDLGraphicsProgram(1920,1080);
-	// Run our program forever
-	mySDLGraphicsProgram.Loop();
-	// When our program ends, it will exit scope, the
-	// destructor will then be called and clean up the program.
-	return 0;
-}
+// Support Code written by Michael D. Shah
+// Last Updated: 1/21/17
+// Please do not redistribute without asking permission.
+
+// Functionality that we created
+#include "SDLGraphicsProgram.hpp"
+
+int main(int argc, char** argv){
+
+	// Create an instance of an object for a SDLGraphicsProgram
+	SDLGraphicsProgram mySDLGraphicsProgram(1920,1080);
+	// Optionally play back a move script given on the command line
+	if(argc > 1){
+		mySDLGraphicsProgram.LoadScript(argv[1]);
+	}
+	// Run our program forever
+	mySDLGraphicsProgram.Loop();
+	// When our program ends, it will exit scope, the
+	// destructor will then be called and clean up the program.
+	return 0;
+}
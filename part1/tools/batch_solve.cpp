@@ -0,0 +1,256 @@
+// Solves a corpus of scrambles on every core, for offline runs.
+// Scrambles stream in one per line from a file or stdin and are solved by
+// worker threads, with only a bounded window of them in memory at a time.
+// Solutions come out in input order, each with its length, time and nodes
+// as a comment, so the output can be fed back to ./replay.
+// Uses the two-phase solver of the interactive build, the optimal one
+// with the pattern databases pdbgen wrote, or Thistlethwaite's for longer
+// solutions at the lowest latency.
+// Usage: ./batch_solve <file|-> [threads] [twophase|optimal|thistlethwaite] [table directory] > solutions
+#include "MoveParser.hpp"
+#include "OptimalSolver.hpp"
+#include "ThistlethwaiteSolver.hpp"
+#include "TwoPhaseSolver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Scrambles in flight between the reader and the workers, and solutions
+// waiting for the ones before them to finish. At most WINDOW scrambles
+// are between being read and being written, so memory stays bounded
+// however large the input is and however slow one scramble is.
+class Pipeline{
+public:
+    static const long long WINDOW_PER_THREAD = 64;
+
+    Pipeline(int threads, std::ostream& out):m_window(WINDOW_PER_THREAD*threads), m_out(out){}
+
+    // Add a scramble, waits while the window is full
+    void Push(const CubeState& cube){
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this]{ return m_read - m_written < m_window; });
+        m_jobs.push_back(Job{m_read++, cube});
+        m_notEmpty.notify_one();
+    }
+
+    // No more scrambles are coming
+    void Close(){
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_notEmpty.notify_all();
+    }
+
+    // Next scramble for a worker, false once the input is done
+    bool Pop(long long& index, CubeState& cube){
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this]{ return !m_jobs.empty() || m_closed; });
+        if (m_jobs.empty()){
+            return false;
+        }
+        index = m_jobs.front().index;
+        cube = m_jobs.front().cube;
+        m_jobs.pop_front();
+        return true;
+    }
+
+    // Hand in the output line of a scramble, written once every scramble
+    // before it is written
+    void Complete(long long index, std::string line){
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done[index] = std::move(line);
+        for (auto next = m_done.find(m_written); next != m_done.end(); next = m_done.find(m_written)){
+            m_out << next->second << "\n";
+            m_done.erase(next);
+            m_written++;
+        }
+        m_notFull.notify_one();
+    }
+
+private:
+    struct Job{
+        long long index;
+        CubeState cube;
+    };
+
+    long long m_window;
+    std::ostream& m_out;
+    std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    std::deque<Job> m_jobs;
+    std::map<long long, std::string> m_done;
+    long long m_read = 0;
+    long long m_written = 0;
+    bool m_closed = false;
+};
+
+// scrambles a cube while a line is parsed and queues it at the end of the line
+class BatchSink : public MoveParser::Sink{
+public:
+    BatchSink(Pipeline& pipeline):m_pipeline(pipeline){}
+    void OnMove(Move move) override{
+        m_cube.ApplyMove(move);
+    }
+    void OnSequenceEnd() override{
+        m_pipeline.Push(m_cube);
+        m_cube.Reset();
+    }
+
+private:
+    Pipeline& m_pipeline;
+    CubeState m_cube;
+};
+
+// totals over every scramble a worker solved
+struct WorkerTotals{
+    long long solves = 0;
+    long long failed = 0;
+    long long wrong = 0;
+    long long moves = 0;
+    long long nodes = 0;
+    double seconds = 0.0;
+};
+
+int main(int argc, char** argv){
+    std::ios::sync_with_stdio(false);
+    if (argc < 2){
+        std::cout << "Usage: " << argv[0] << " <file|-> [threads] [twophase|optimal|thistlethwaite] [table directory]\n";
+        return 1;
+    }
+    std::string path = argv[1];
+    int threads = argc > 2 ? std::atoi(argv[2]) : 0;
+    if (threads <= 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::string solverName = argc > 3 ? argv[3] : "twophase";
+    std::string directory = argc > 4 ? argv[4] : "tables";
+    if (solverName != "twophase" && solverName != "optimal" && solverName != "thistlethwaite"){
+        std::cout << "Unknown solver " << solverName << ", use twophase, optimal or thistlethwaite\n";
+        return 1;
+    }
+
+    std::ifstream file;
+    if (path != "-"){
+        file.open(path, std::ios::binary);
+        if (!file){
+            std::cout << "Could not open " << path << "\n";
+            return 1;
+        }
+    }
+    std::istream& in = path == "-" ? std::cin : file;
+
+    // one solver shared by every worker, all are safe to share
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<TwoPhaseSolver> twoPhase;
+    std::unique_ptr<OptimalSolver> optimal;
+    std::unique_ptr<ThistlethwaiteSolver> thistlethwaite;
+    if (solverName == "optimal"){
+        optimal.reset(new OptimalSolver(directory, threads));
+        std::cerr << "tables: " << optimal->TablesLoaded() << "/" << OptimalSolver::NUM_TABLES
+                  << " mapped from " << directory;
+    } else if (solverName == "thistlethwaite"){
+        thistlethwaite.reset(new ThistlethwaiteSolver());
+        std::cerr << "tables built";
+    } else {
+        twoPhase.reset(new TwoPhaseSolver());
+        std::cerr << "tables built";
+    }
+    double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << " in " << tableSeconds << " s, solving with " << threads << " threads\n";
+
+    Pipeline pipeline(threads, std::cout);
+    std::vector<WorkerTotals> totals(threads);
+    auto work = [&](int worker){
+        WorkerTotals& total = totals[worker];
+        long long index;
+        CubeState cube;
+        std::vector<Move> solution;
+        while (pipeline.Pop(index, cube)){
+            auto solveStart = std::chrono::steady_clock::now();
+            long long nodes = 0;
+            bool solved;
+            if (optimal){
+                OptimalSolver::Statistics statistics;
+                solved = optimal->Solve(cube, solution, &statistics);
+                nodes = statistics.nodes;
+            } else if (thistlethwaite){
+                solved = thistlethwaite->Solve(cube, solution);
+            } else {
+                solved = twoPhase->Solve(cube, solution, 20, 0.1, &nodes);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - solveStart).count();
+
+            std::ostringstream line;
+            if (!solved){
+                line << "// unsolvable";
+                total.failed++;
+            } else {
+                CubeState check = cube;
+                for (Move move : solution){
+                    check.ApplyMove(move);
+                }
+                if (!check.IsSolvedIgnoringCenterSpin()){
+                    total.wrong++;
+                }
+                line << MoveParser::ToString(solution) << " // " << solution.size() << " moves, "
+                     << seconds*1e3 << " ms, " << nodes << " nodes";
+                total.solves++;
+                total.moves += solution.size();
+            }
+            total.nodes += nodes;
+            total.seconds += seconds;
+            pipeline.Complete(index, line.str());
+        }
+    };
+
+    start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int worker=0; worker<threads; worker++){
+        workers.emplace_back(work, worker);
+    }
+    BatchSink sink(pipeline);
+    MoveParser parser(sink);
+    bool parsed = parser.ParseStream(in);
+    pipeline.Close();
+    for (std::thread& worker : workers){
+        worker.join();
+    }
+    std::cout.flush();
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!parsed){
+        std::cerr << "input: " << parser.GetError() << "\n";
+    }
+
+    WorkerTotals sum;
+    for (const WorkerTotals& total : totals){
+        sum.solves += total.solves;
+        sum.failed += total.failed;
+        sum.wrong += total.wrong;
+        sum.moves += total.moves;
+        sum.nodes += total.nodes;
+        sum.seconds += total.seconds;
+    }
+    if (sum.solves > 0){
+        std::cerr << "solved: " << sum.solves << " in " << wallSeconds << " s"
+                  << " (" << sum.solves/wallSeconds << " per second)"
+                  << ", average length: " << double(sum.moves)/sum.solves
+                  << ", average time: " << sum.seconds/sum.solves*1e3 << " ms"
+                  << ", nodes: " << sum.nodes << "\n";
+    }
+    if (sum.failed > 0 || sum.wrong > 0){
+        std::cerr << "unsolvable: " << sum.failed << ", wrong solutions: " << sum.wrong << "\n";
+    }
+    return !parsed || sum.failed > 0 || sum.wrong > 0 ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+// Throughput benchmark for CubeBatch.
+// Usage: ./bench_batch [states] [moves per state]
+#include "CubeBatch.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// small deterministic generator so every run times the same work
+static uint32_t NextRandom(uint32_t& seed){
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+int main(int argc, char** argv){
+    size_t numStates = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    size_t numSteps = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+
+    // one move per step for the "same move" run, one move per lane per step otherwise
+    uint32_t seed = 2463534242u;
+    std::vector<Move> sameMoves(numSteps);
+    std::vector<Move> laneMoves(numSteps*numStates);
+    for (Move& m : sameMoves){
+        m = static_cast<Move>(NextRandom(seed) % CubeState::NUM_MOVES);
+    }
+    for (Move& m : laneMoves){
+        m = static_cast<Move>(NextRandom(seed) % CubeState::NUM_MOVES);
+    }
+
+    std::cout << "states: " << numStates << ", moves per state: " << numSteps
+              << ", best: " << CubeBatch::Name(CubeBatch::Best()) << "\n";
+
+    std::vector<CubeState> reference;
+    std::vector<CubeState> referenceLanes;
+    const CubeBatch::Implementation implementations[] = {
+        CubeBatch::Implementation::SCALAR,
+        CubeBatch::Implementation::SSSE3,
+        CubeBatch::Implementation::AVX2
+    };
+    for (CubeBatch::Implementation implementation : implementations){
+        if (!CubeBatch::Supported(implementation)){
+            std::cout << CubeBatch::Name(implementation) << ": not supported\n";
+            continue;
+        }
+
+        std::vector<CubeState> states(numStates);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t step=0; step<numSteps; step++){
+            CubeBatch::ApplyMove(states.data(), numStates, sameMoves[step], implementation);
+        }
+        double sameSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<CubeState> lanes(numStates);
+        start = std::chrono::steady_clock::now();
+        for (size_t step=0; step<numSteps; step++){
+            CubeBatch::ApplyMoves(lanes.data(), &laneMoves[step*numStates], numStates, implementation);
+        }
+        double laneSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // every implementation has to agree with the scalar one
+        if (reference.empty()){
+            reference = states;
+            referenceLanes = lanes;
+        }
+        bool matches = states == reference && lanes == referenceLanes;
+
+        double totalMoves = double(numStates)*double(numSteps);
+        std::cout << CubeBatch::Name(implementation)
+                  << ": same move " << totalMoves/sameSeconds/1e6 << " Mmoves/s"
+                  << ", move per lane " << totalMoves/laneSeconds/1e6 << " Mmoves/s"
+                  << (matches ? "" : "  MISMATCH") << "\n";
+        if (!matches){
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Speedup of the parallel optimal solver over a fixed set of scrambles.
+// Solves the whole set with 1, 2, 4, ... threads up to the given count and
+// reports time, nodes/s and speedup over one thread. Every thread count has
+// to find the same solutions.
+// Usage: ./bench_optimal [max threads] [table directory]
+#include "MoveParser.hpp"
+#include "OptimalSolver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// random 13 move scrambles, a few million nodes each
+static const char* SCRAMBLES[] = {
+    "U2 B2 L F2 B D' B' D F B2 L B2 R",
+    "B U2 F U' R' D2 L B2 U2 L2 B' R B'",
+    "L2 F' L D' L' U F' U R2 D B2 L D'",
+    "B L' D' L F' D L' U2 R' B' L' U2 D'",
+    "U' B2 D' F' L U2 L' F D R' U L2 F2",
+    "F' U R U F2 R L2 F' B' U2 L2 B D'",
+    "R' L2 F' L B' D' F R U2 R F' D L'",
+    "U F2 L' D R B R B L2 B L' D' F"
+};
+
+int main(int argc, char** argv){
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : 0;
+    if (maxThreads <= 0){
+        maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::string directory = argc > 2 ? argv[2] : "tables";
+
+    OptimalSolver solver(directory);
+    std::cout << "tables: " << solver.TablesLoaded() << "/" << OptimalSolver::NUM_TABLES
+              << " mapped from " << directory << ", cores: " << std::thread::hardware_concurrency() << "\n";
+
+    std::vector<CubeState> cubes;
+    for (const char* scramble : SCRAMBLES){
+        std::vector<Move> moves;
+        if (!MoveParser::ParseString(scramble, moves)){
+            std::cerr << "bad scramble: " << scramble << "\n";
+            return 1;
+        }
+        CubeState cube;
+        for (Move move : moves){
+            cube.ApplyMove(move);
+        }
+        cubes.push_back(cube);
+    }
+
+    std::vector<int> threadCounts;
+    for (int threads=1; threads<maxThreads; threads*=2){
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double oneThreadSeconds = 0.0;
+    std::vector<std::vector<Move>> reference;
+    for (int threads : threadCounts){
+        std::vector<std::vector<Move>> solutions(cubes.size());
+        long long nodes = 0;
+        double seconds = 0.0;
+        for (size_t i=0; i<cubes.size(); i++){
+            OptimalSolver::Statistics statistics;
+            if (!solver.Solve(cubes[i], solutions[i], &statistics, OptimalSolver::MAX_LENGTH, threads)){
+                std::cerr << "no solution for " << SCRAMBLES[i] << "\n";
+                return 1;
+            }
+            nodes += statistics.nodes;
+            seconds += statistics.seconds;
+        }
+        if (reference.empty()){
+            reference = solutions;
+            oneThreadSeconds = seconds;
+        }
+        bool matches = solutions == reference;
+        std::cout << threads << " threads: " << seconds << " s, " << nodes << " nodes, "
+                  << nodes/seconds/1e6 << " M nodes/s, speedup " << oneThreadSeconds/seconds
+                  << (matches ? "" : "  MISMATCH") << "\n";
+        if (!matches){
+            return 1;
+        }
+    }
+    return 0;
+}
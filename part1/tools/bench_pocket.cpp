@@ -0,0 +1,70 @@
+// Enumerates every state of the 2x2x2 cube by breadth first search, an end
+// to end benchmark of the corner move tables. Prints the number of states
+// at each distance, then the time and states/s with 1, 2, 4, ... threads
+// up to the given count and the speedup over one thread. Every thread
+// count has to find the same distances.
+// Usage: ./bench_pocket [max threads] [runs per thread count]
+#include "PocketCube.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv){
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : 0;
+    if (maxThreads <= 0){
+        maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    int runs = argc > 2 ? std::max(1, std::atoi(argv[2])) : 3;
+
+    auto start = std::chrono::steady_clock::now();
+    PocketCube pocket;
+    double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "states: " << PocketCube::NUM_STATES << ", tables built in " << tableSeconds
+              << " s, cores: " << std::thread::hardware_concurrency() << "\n";
+
+    std::vector<int> threadCounts;
+    for (int threads=1; threads<maxThreads; threads*=2){
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double oneThreadSeconds = 0.0;
+    std::vector<uint64_t> reference;
+    for (int threads : threadCounts){
+        // the best of a few runs, the first one also pays for page faults
+        double seconds = 0.0;
+        std::vector<uint64_t> counts;
+        for (int run=0; run<runs; run++){
+            auto runStart = std::chrono::steady_clock::now();
+            counts = pocket.Enumerate(threads);
+            double runSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+            seconds = run == 0 ? runSeconds : std::min(seconds, runSeconds);
+        }
+        if (reference.empty()){
+            reference = counts;
+            oneThreadSeconds = seconds;
+            uint64_t total = 0;
+            std::cout << "distance  states\n";
+            for (size_t depth=0; depth<counts.size(); depth++){
+                std::cout << depth << "  " << counts[depth] << "\n";
+                total += counts[depth];
+            }
+            std::cout << "total  " << total << "\n";
+            if (total != uint64_t(PocketCube::NUM_STATES)){
+                std::cout << "MISSING " << PocketCube::NUM_STATES - total << " states\n";
+                return 1;
+            }
+        }
+        bool matches = counts == reference;
+        std::cout << threads << " threads: " << seconds << " s, " << PocketCube::NUM_STATES/seconds/1e6
+                  << " M states/s, speedup " << oneThreadSeconds/seconds << (matches ? "" : "  MISMATCH") << "\n";
+        if (!matches){
+            return 1;
+        }
+    }
+    return 0;
+}
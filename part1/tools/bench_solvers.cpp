@@ -0,0 +1,108 @@
+// Latency, memory and solution length of every solver on the same
+// deterministic random scrambles. Thistlethwaite's, the CFOP and the
+// two-phase solver take all of them; the optimal one only the first few, as each
+// random cube takes it seconds to minutes, and is skipped by default.
+// Usage: ./bench_solvers [scrambles] [optimal scrambles] [table directory]
+#include "CfopSolver.hpp"
+#include "OptimalSolver.hpp"
+#include "ThistlethwaiteSolver.hpp"
+#include "TwoPhaseSolver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// small deterministic generator so every run times the same work
+static uint32_t NextRandom(uint32_t& seed){
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+// solves the first count cubes with solve and prints one row of the report
+static bool Measure(const char* name, const std::vector<CubeState>& cubes, size_t count, size_t bytes,
+                    double setupSeconds, const std::function<bool(const CubeState&, std::vector<Move>&)>& solve){
+    std::vector<Move> solution;
+    double totalSeconds = 0.0;
+    double maxSeconds = 0.0;
+    long long totalMoves = 0;
+    size_t maxMoves = 0;
+    long long failed = 0;
+    for (size_t i=0; i<count; i++){
+        auto start = std::chrono::steady_clock::now();
+        bool solved = solve(cubes[i], solution);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        CubeState check = cubes[i];
+        for (Move move : solution){
+            check.ApplyMove(move);
+        }
+        if (!solved || !check.IsSolvedIgnoringCenterSpin()){
+            failed++;
+            continue;
+        }
+        totalSeconds += seconds;
+        maxSeconds = std::max(maxSeconds, seconds);
+        totalMoves += solution.size();
+        maxMoves = std::max(maxMoves, solution.size());
+    }
+    long long solved = count - failed;
+    std::cout << name << ": " << solved << " solved, latency average " << (solved > 0 ? totalSeconds/solved*1e6 : 0.0)
+              << " us, max " << maxSeconds*1e6 << " us, memory " << bytes/1024 << " KiB, setup " << setupSeconds
+              << " s, length average " << (solved > 0 ? double(totalMoves)/solved : 0.0) << ", max " << maxMoves;
+    if (failed > 0){
+        std::cout << "  FAILED " << failed;
+    }
+    std::cout << "\n";
+    return failed == 0;
+}
+
+static double SecondsSince(std::chrono::steady_clock::time_point start){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv){
+    size_t numScrambles = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    size_t numOptimal = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 0;
+    std::string directory = argc > 3 ? argv[3] : "tables";
+    numOptimal = std::min(numOptimal, numScrambles);
+
+    // 40 random face turns, as good as a random state for every solver here
+    uint32_t seed = 2463534242u;
+    std::vector<CubeState> cubes(numScrambles);
+    for (CubeState& cube : cubes){
+        for (int i=0; i<40; i++){
+            cube.ApplyMove(static_cast<Move>(NextRandom(seed) % CubeState::NUM_FACE_MOVES));
+        }
+    }
+    std::cout << "scrambles: " << numScrambles << ", optimal: " << numOptimal << "\n";
+
+    bool ok = true;
+    auto start = std::chrono::steady_clock::now();
+    ThistlethwaiteSolver thistlethwaite;
+    ok &= Measure("thistlethwaite", cubes, numScrambles, ThistlethwaiteSolver::MemoryFootprint(), SecondsSince(start),
+                  [&](const CubeState& cube, std::vector<Move>& solution){ return thistlethwaite.Solve(cube, solution); });
+
+    start = std::chrono::steady_clock::now();
+    CfopSolver cfop(directory);
+    ok &= Measure("cfop", cubes, numScrambles, cfop.MemoryFootprint(), SecondsSince(start),
+                  [&](const CubeState& cube, std::vector<Move>& solution){ return cfop.Solve(cube, solution); });
+
+    start = std::chrono::steady_clock::now();
+    TwoPhaseSolver twoPhase;
+    ok &= Measure("twophase", cubes, numScrambles, twoPhase.MemoryFootprint(), SecondsSince(start),
+                  [&](const CubeState& cube, std::vector<Move>& solution){ return twoPhase.Solve(cube, solution); });
+
+    if (numOptimal > 0){
+        start = std::chrono::steady_clock::now();
+        OptimalSolver optimal(directory);
+        ok &= Measure("optimal", cubes, numOptimal, optimal.MemoryFootprint(), SecondsSince(start),
+                      [&](const CubeState& cube, std::vector<Move>& solution){ return optimal.Solve(cube, solution); });
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+// Solves every line of a scramble file optimally by meet-in-the-middle
+// search, for scrambles up to about 14 moves. Prints one solution per line,
+// with the states generated, how deep each side went and what was spilled
+// to disk. The levels from the solved cube are shared by every scramble.
+// Usage: ./bidirectional [max length] [memory MiB] [work directory] < scrambles > solutions
+#include "BidirectionalSolver.hpp"
+#include "MoveParser.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// scrambles a cube while a line is parsed and solves it at the end of the line
+class BidirectionalSink : public MoveParser::Sink{
+public:
+    BidirectionalSink(BidirectionalSolver& solver, int maxLength)
+        :m_solver(solver), m_maxLength(maxLength){}
+    void OnMove(Move move) override{
+        m_cube.ApplyMove(move);
+    }
+    void OnSequenceEnd() override{
+        BidirectionalSolver::Statistics statistics;
+        bool solved = m_solver.Solve(m_cube, m_solution, &statistics, m_maxLength);
+        if (!solved){
+            std::cout << "no solution within " << m_maxLength << " moves\n";
+            failed++;
+            m_cube.Reset();
+            return;
+        }
+        for (Move move : m_solution){
+            m_cube.ApplyMove(move);
+        }
+        if (!m_cube.IsSolvedIgnoringCenterSpin()){
+            wrong++;
+        }
+        m_cube.Reset();
+        std::cout << MoveParser::ToString(m_solution) << "\n";
+        std::cerr << "  " << m_solution.size() << " moves, " << statistics.states << " states in "
+                  << statistics.seconds << " s, depth " << statistics.scrambleDepth << " + "
+                  << statistics.solvedDepth;
+        if (statistics.runs > 0){
+            std::cerr << ", spilled " << statistics.runs << " runs, "
+                      << statistics.spilledBytes/(1024.0*1024.0) << " MiB";
+        }
+        std::cerr << "\n";
+        solves++;
+        totalStates += statistics.states;
+        totalSeconds += statistics.seconds;
+    }
+
+    long long solves = 0;
+    long long failed = 0;
+    long long wrong = 0;
+    long long totalStates = 0;
+    double totalSeconds = 0.0;
+
+private:
+    BidirectionalSolver& m_solver;
+    int m_maxLength;
+    CubeState m_cube;
+    std::vector<Move> m_solution;
+};
+
+int main(int argc, char** argv){
+    std::ios::sync_with_stdio(false);
+    int maxLength = argc > 1 ? std::atoi(argv[1]) : BidirectionalSolver::MAX_LENGTH;
+    size_t memoryBytes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) << 20 : BidirectionalSolver::DEFAULT_MEMORY_BYTES;
+    std::string directory = argc > 3 ? argv[3] : ".";
+
+    BidirectionalSolver solver(memoryBytes, directory);
+    BidirectionalSink sink(solver, maxLength);
+    MoveParser parser(sink);
+    if (!parser.ParseStream(std::cin)){
+        std::cerr << "input: " << parser.GetError() << "\n";
+        return 1;
+    }
+    if (sink.solves > 0){
+        std::cerr << "solved: " << sink.solves << ", states: " << sink.totalStates
+                  << ", time: " << sink.totalSeconds << " s\n";
+    }
+    if (sink.failed > 0 || sink.wrong > 0){
+        std::cerr << "not solved: " << sink.failed << ", wrong solutions: " << sink.wrong << "\n";
+    }
+    return sink.failed > 0 || sink.wrong > 0 ? 1 : 0;
+}
@@ -0,0 +1,85 @@
+// Solves every line of a scramble file layer by layer, the way people do:
+// cross, the four first two layer pairs, then the whole last layer from one
+// lookup in the table ./llgen wrote. Prints one solution per line, with the
+// moves of each stage and the time.
+// Usage: ./cfop [table directory] < scrambles > solutions
+#include "CfopSolver.hpp"
+#include "MoveParser.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// scrambles a cube while a line is parsed and solves it at the end of the line
+class CfopSink : public MoveParser::Sink{
+public:
+    CfopSink(const CfopSolver& solver):m_solver(solver){}
+    void OnMove(Move move) override{
+        m_cube.ApplyMove(move);
+    }
+    void OnSequenceEnd() override{
+        CfopSolver::Stages stages;
+        auto start = std::chrono::steady_clock::now();
+        bool solved = m_solver.Solve(m_cube, m_solution, &stages);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!solved){
+            std::cout << "// unsolvable\n";
+            failed++;
+            m_cube.Reset();
+            return;
+        }
+        for (Move move : m_solution){
+            m_cube.ApplyMove(move);
+        }
+        if (!m_cube.IsSolvedIgnoringCenterSpin()){
+            wrong++;
+        }
+        m_cube.Reset();
+        std::cout << MoveParser::ToString(m_solution) << "\n";
+        std::cerr << "  " << m_solution.size() << " moves: cross " << stages.cross << ", pairs";
+        for (int pair=0; pair<CfopSolver::NUM_PAIRS; pair++){
+            std::cerr << " " << stages.pairs[pair];
+        }
+        std::cerr << ", last layer " << stages.lastLayer << ", " << seconds*1e3 << " ms\n";
+        solves++;
+        totalMoves += m_solution.size();
+        totalSeconds += seconds;
+    }
+
+    long long solves = 0;
+    long long failed = 0;
+    long long wrong = 0;
+    long long totalMoves = 0;
+    double totalSeconds = 0.0;
+
+private:
+    const CfopSolver& m_solver;
+    CubeState m_cube;
+    std::vector<Move> m_solution;
+};
+
+int main(int argc, char** argv){
+    std::ios::sync_with_stdio(false);
+    std::string directory = argc > 1 ? argv[1] : "tables";
+
+    auto start = std::chrono::steady_clock::now();
+    CfopSolver solver(directory);
+    double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "last layer table " << (solver.TableLoaded() ? "mapped from " + directory : std::string("generated"))
+              << " in " << tableSeconds << " s, " << solver.MemoryFootprint()/1024 << " KiB\n";
+
+    CfopSink sink(solver);
+    MoveParser parser(sink);
+    if (!parser.ParseStream(std::cin)){
+        std::cerr << "input: " << parser.GetError() << "\n";
+        return 1;
+    }
+    if (sink.solves > 0){
+        std::cerr << "solved: " << sink.solves << ", average length: " << double(sink.totalMoves)/sink.solves
+                  << ", average time: " << sink.totalSeconds/sink.solves*1e3 << " ms\n";
+    }
+    if (sink.failed > 0 || sink.wrong > 0){
+        std::cerr << "unsolvable: " << sink.failed << ", wrong solutions: " << sink.wrong << "\n";
+    }
+    return sink.failed > 0 || sink.wrong > 0 ? 1 : 0;
+}
@@ -0,0 +1,141 @@
+// Checks engine behavior that is easy to break without noticing: prints
+// every check that fails and exits with 1 if any did.
+// Usage: ./check
+#include "CubieCube.hpp"
+#include "LastLayerTable.hpp"
+#include "MoveParser.hpp"
+#include "RandomState.hpp"
+#include "ThistlethwaiteSolver.hpp"
+#include "TwoPhaseSolver.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int failures = 0;
+
+void Check(bool passed, const std::string& what){
+    if (!passed){
+        std::cout << "FAILED: " << what << "\n";
+        failures++;
+    }
+}
+
+// a cube turned by one whole cube rotation is brought back by one
+void CheckCenterRotations(){
+    const char* scrambles[] = {"x", "x2", "x'", "y", "y2", "y'", "z", "z2", "z'", "x R U", "y' F D2 L"};
+    for (const char* scramble : scrambles){
+        std::vector<Move> moves;
+        MoveParser::ParseString(scramble, moves);
+        CubeState state;
+        for (Move move : moves){
+            state.ApplyMove(move);
+        }
+        std::vector<Move> rotations;
+        bool found = CubieCube::FindCenterRotations(state, rotations);
+        for (Move move : rotations){
+            state.ApplyMove(move);
+        }
+        std::vector<Move> more;
+        bool home = CubieCube::FindCenterRotations(state, more) && more.empty();
+        Check(found && rotations.size() == 1 && home,
+              std::string("FindCenterRotations(\"") + scramble + "\") gave \"" + MoveParser::ToString(rotations) + "\"");
+    }
+}
+
+// brackets mean what they say, or are an error, never something else
+void CheckParserBrackets(){
+    const char* parsed[][2] = {
+        {"(R U)2", "R U R U"},
+        {"[R U]'", "U' R'"},
+        {"[R, U]", "R U R' U'"},
+        {"[R: U]", "R U R'"},
+        {"[R U, D]2", "R U D U' R' D' R U D U' R' D'"},
+        {"[F: [R, U]]", "F R U R' U' F'"},
+        {"[(R U)2: D]'", "R U R U D' U' R' U' R'"}
+    };
+    for (const auto& test : parsed){
+        std::vector<Move> moves;
+        std::string error;
+        bool ok = MoveParser::ParseString(test[0], moves, &error);
+        Check(ok && MoveParser::ToString(moves) == test[1],
+              std::string("\"") + test[0] + "\" parsed as \"" + (ok ? MoveParser::ToString(moves) : error) + "\", not \"" + test[1] + "\"");
+    }
+    const char* rejected[] = {"R, U", "(R, U)", "(R: U)", "[R, U, F]", "[R: U, F]", "(R U]", "[R U)"};
+    for (const char* text : rejected){
+        std::vector<Move> moves;
+        Check(!MoveParser::ParseString(text, moves),
+              std::string("\"") + text + "\" parsed as \"" + MoveParser::ToString(moves) + "\", not an error");
+    }
+}
+
+// a last layer table file with an entry or a move out of range does not load
+void CheckLastLayerTableFile(){
+    std::vector<std::vector<Move>> algorithms(LastLayerTable::NUM_CASES);
+    MoveParser::ParseString("R U R' U R U2 R'", algorithms[1]);
+    LastLayerTable table;
+    table.Reset(algorithms);
+    std::string path = (std::filesystem::temp_directory_path() / "check.lla").string();
+    if (!table.Save(path)){
+        Check(false, "saving a last layer table to " + path);
+        return;
+    }
+    LastLayerTable loaded;
+    Check(loaded.Load(path) && loaded.Length(1) == 7, "loading a saved last layer table");
+
+    const uint64_t entries = LastLayerTable::FILE_DATA_OFFSET;
+    const uint64_t moves = entries + LastLayerTable::NUM_CASES*sizeof(uint32_t);
+    // entry 1 pointing past the moves, then a move that is not a face turn
+    const std::pair<uint64_t, uint32_t> damages[] = {{entries + 4, 100u << 8 | 7u}, {moves + 3, 200u}};
+    for (const auto& damage : damages){
+        table.Save(path);
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(damage.first);
+            if (damage.first < moves){
+                file.write(reinterpret_cast<const char*>(&damage.second), sizeof(damage.second));
+            } else {
+                char byte = char(damage.second);
+                file.write(&byte, 1);
+            }
+        }
+        LastLayerTable damaged;
+        Check(!damaged.Load(path), "loading a last layer table damaged at byte " + std::to_string(damage.first));
+    }
+    std::remove(path.c_str());
+}
+
+// a random_states scramble followed by the solution batch_solve writes for
+// it, comment and all, replays to a solved cube the way ./replay counts it
+void CheckReplayedSolutions(){
+    ThistlethwaiteSolver thistlethwaite;
+    TwoPhaseSolver twoPhase;
+    for (uint64_t index=0; index<5; index++){
+        CubieCube cube = RandomState::Generate(3, index);
+        std::string scramble = MoveParser::ToString(RandomState::Scramble(cube, thistlethwaite));
+        std::vector<Move> solution;
+        bool solved = twoPhase.Solve(cube.ToState(), solution, 20, 0.1);
+        std::string line = scramble + " " + MoveParser::ToString(solution) + " // "
+                         + std::to_string(solution.size()) + " moves";
+        std::vector<Move> moves;
+        CubeState state;
+        if (solved && MoveParser::ParseString(line, moves)){
+            for (Move move : moves){
+                state.ApplyMove(move);
+            }
+        }
+        Check(solved && state.IsSolvedIgnoringCenterSpin(), "replaying \"" + line + "\"");
+    }
+}
+
+int main(){
+    CheckCenterRotations();
+    CheckParserBrackets();
+    CheckLastLayerTableFile();
+    CheckReplayedSolutions();
+    std::cout << (failures == 0 ? "all checks passed" : "some checks failed") << "\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+// Runs the cube simulation with no window or OpenGL context and reports timings.
+// Usage: ./headless [turns] [seconds per quarter turn] [frames per second]
+#include "CubeSimulation.hpp"
+#include "AnimationClock.hpp"
+#include "ZobristHash.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+// small deterministic generator so every run times the same work
+static uint32_t NextRandom(uint32_t& seed){
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+int main(int argc, char** argv){
+    long long numTurns = argc > 1 ? std::atoll(argv[1]) : 1000000;
+    float turnDuration = argc > 2 ? std::atof(argv[2]) : CubeSimulation::MIN_TURN_DURATION;
+    double framesPerSecond = argc > 3 ? std::atof(argv[3]) : 60.0;
+
+    CubeSimulation simulation;
+    simulation.SetTurnDuration(turnDuration);
+    simulation.SetCountStateVisits(true);
+    AnimationClock animationClock(1.0/120.0);
+    // the same moves applied straight to a cube, to check the simulation against
+    CubeState expected;
+
+    uint32_t seed = 2463534242u;
+    long long queuedTurns = 0;
+    long long frames = 0;
+    long long steps = 0;
+    double stepSeconds = 0.0;
+    double transformSeconds = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (simulation.CompletedMoves() < numTurns){
+        // keep the queue topped up like a fast typist or a script would
+        while (queuedTurns < numTurns && simulation.QueuedMoves() < MoveQueue::CAPACITY/2){
+            Move move = static_cast<Move>(NextRandom(seed) % CubeState::NUM_MOVES);
+            simulation.QueueMove(move);
+            expected.ApplyMove(move);
+            queuedTurns++;
+        }
+
+        // one frame of simulated wall clock time, then lay out the sub cubes
+        auto stepStart = std::chrono::steady_clock::now();
+        int frameSteps = animationClock.Advance(1.0/framesPerSecond);
+        for (int i=0; i<frameSteps; i++){
+            simulation.Step(animationClock.StepSeconds());
+        }
+        auto transformStart = std::chrono::steady_clock::now();
+        simulation.ComputeTransforms(animationClock.Alpha());
+        auto frameEnd = std::chrono::steady_clock::now();
+
+        stepSeconds += std::chrono::duration<double>(transformStart - stepStart).count();
+        transformSeconds += std::chrono::duration<double>(frameEnd - transformStart).count();
+        steps += frameSteps;
+        frames++;
+    }
+    double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool matches = simulation.GetCubeState() == expected
+                && simulation.GetStateHash() == ZobristHash::Compute(expected);
+    std::cout << "turns: " << simulation.CompletedMoves()
+              << ", frames: " << frames
+              << ", steps: " << steps
+              << ", distinct states: " << simulation.DistinctStates() << "\n";
+    std::cout << "wall time: " << totalSeconds << " s"
+              << ", turns/s: " << simulation.CompletedMoves()/totalSeconds << "\n";
+    std::cout << "step: " << stepSeconds/steps*1e9 << " ns"
+              << ", transforms per frame: " << transformSeconds/frames*1e9 << " ns\n";
+    std::cout << "final state and hash " << (matches ? "match" : "DO NOT match") << " the move sequence\n";
+    return matches ? 0 : 1;
+}
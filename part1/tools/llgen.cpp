@@ -0,0 +1,92 @@
+// Generates the tables of the CFOP solver. The pair table of the first two
+// layers comes from a search for each case, a few seconds on one core. The
+// last layer table lists every sequence of up to max length face turns that
+// keeps the first two layers (the time grows about eight times per move, 12
+// takes about a minute on one core) and joins short ones for the cases they
+// miss. Checks that every algorithm solves its case and writes both tables
+// to the directory.
+// Usage: ./llgen [table directory] [max length] [threads]
+#include "CfopSolver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv){
+    std::string directory = argc > 1 ? argv[1] : "tables";
+    int maxLength = argc > 2 ? std::atoi(argv[2]) : CfopSolver::DEFAULT_TABLE_LENGTH;
+    int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+
+    auto start = std::chrono::steady_clock::now();
+    AlgorithmTable pairs(CfopSolver::NUM_PAIR_CASES, CfopSolver::PAIR_TABLE_MAGIC);
+    CfopSolver::GeneratePairTable(pairs, threads);
+    double pairSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    int pairCases = 0;
+    int wrongPairs = CfopSolver::CheckPairTable(pairs, &pairCases);
+    long long pairMoves = 0;
+    for (int number=0; number<pairs.NumCases(); number++){
+        pairMoves += std::max(0, pairs.Length(number));
+    }
+    std::cout << "pair cases: " << pairCases << ", average length " << double(pairMoves)/pairCases << ", "
+              << pairs.Bytes()/1024 << " KiB, generated in " << pairSeconds << " s\n";
+    if (wrongPairs > 0){
+        std::cout << "missing or wrong pair algorithms: " << wrongPairs << "\n";
+        return 1;
+    }
+    std::string pairPath = CfopSolver::PairTablePath(directory);
+    if (!pairs.Save(pairPath)){
+        return 1;
+    }
+    std::cout << "wrote " << pairPath << "\n";
+
+    start = std::chrono::steady_clock::now();
+    LastLayerTable table;
+    CfopSolver::GenerateTable(table, maxLength, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<long long> lengths;
+    long long totalMoves = 0;
+    long long wrong = 0;
+    std::vector<Move> algorithm;
+    for (int signature=0; signature<LastLayerTable::NUM_CASES; signature++){
+        algorithm.clear();
+        if (!table.Lookup(signature, algorithm)){
+            continue;
+        }
+        CubeState cube = LastLayerTable::CaseCube(signature).ToState();
+        for (Move move : algorithm){
+            cube.ApplyMove(move);
+        }
+        if (!cube.IsSolvedIgnoringCenterSpin()){
+            wrong++;
+        }
+        if (lengths.size() <= algorithm.size()){
+            lengths.resize(algorithm.size() + 1, 0);
+        }
+        lengths[algorithm.size()]++;
+        totalMoves += algorithm.size();
+    }
+    int cases = table.Cases();
+    std::cout << "length  cases\n";
+    for (size_t length=0; length<lengths.size(); length++){
+        if (lengths[length] > 0){
+            std::cout << length << "  " << lengths[length] << "\n";
+        }
+    }
+    std::cout << "cases: " << cases << "/" << LastLayerTable::NUM_CASES << ", average length "
+              << double(totalMoves)/cases << ", " << table.Bytes()/1024 << " KiB, generated in "
+              << seconds << " s\n";
+    if (cases != LastLayerTable::NUM_CASES || wrong > 0){
+        std::cout << "missing: " << LastLayerTable::NUM_CASES - cases << ", wrong algorithms: " << wrong << "\n";
+        return 1;
+    }
+    std::string path = CfopSolver::TablePath(directory);
+    if (!table.Save(path)){
+        return 1;
+    }
+    std::cout << "wrote " << path << "\n";
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Solves every line of a scramble file optimally with IDA* and pattern databases.
+// Prints one solution per line, with nodes expanded per depth bound, nodes/s
+// and the memory the tables take. The pattern databases are mapped from the
+// table directory if pdbgen wrote them there, and generated otherwise.
+// Usage: ./optimal [max length] [table directory] [threads] < scrambles > solutions
+#include "MoveParser.hpp"
+#include "OptimalSolver.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// scrambles a cube while a line is parsed and solves it at the end of the line
+class OptimalSink : public MoveParser::Sink{
+public:
+    OptimalSink(const OptimalSolver& solver, int maxLength, int threads)
+        :m_solver(solver), m_maxLength(maxLength), m_threads(threads){}
+    void OnMove(Move move) override{
+        m_cube.ApplyMove(move);
+    }
+    void OnSequenceEnd() override{
+        OptimalSolver::Statistics statistics;
+        bool solved = m_solver.Solve(m_cube, m_solution, &statistics, m_maxLength, m_threads);
+        m_cube.Reset();
+        if (!solved){
+            std::cout << "no solution within " << m_maxLength << " moves\n";
+            failed++;
+            return;
+        }
+        std::cout << MoveParser::ToString(m_solution) << "\n";
+        std::cerr << "  " << m_solution.size() << " moves, " << statistics.nodes << " nodes in "
+                  << statistics.seconds << " s (" << statistics.NodesPerSecond()/1e6 << " M nodes/s)\n";
+        std::cerr << "  nodes per depth bound:";
+        for (size_t bound=0; bound<statistics.nodesPerIteration.size(); bound++){
+            if (statistics.nodesPerIteration[bound] > 0){
+                std::cerr << " " << bound << ":" << statistics.nodesPerIteration[bound];
+            }
+        }
+        std::cerr << "\n";
+        solves++;
+        totalNodes += statistics.nodes;
+        totalSeconds += statistics.seconds;
+    }
+
+    long long solves = 0;
+    long long failed = 0;
+    long long totalNodes = 0;
+    double totalSeconds = 0.0;
+
+private:
+    const OptimalSolver& m_solver;
+    int m_maxLength;
+    int m_threads;
+    CubeState m_cube;
+    std::vector<Move> m_solution;
+};
+
+int main(int argc, char** argv){
+    std::ios::sync_with_stdio(false);
+    int maxLength = argc > 1 ? std::atoi(argv[1]) : OptimalSolver::MAX_LENGTH;
+    std::string directory = argc > 2 ? argv[2] : "tables";
+    int threads = argc > 3 ? std::atoi(argv[3]) : 1;
+
+    auto start = std::chrono::steady_clock::now();
+    OptimalSolver solver(directory);
+    double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "tables: " << solver.MemoryFootprint()/(1024.0*1024.0) << " MiB, "
+              << solver.TablesLoaded() << "/" << OptimalSolver::NUM_TABLES << " mapped from " << directory
+              << ", ready in " << tableSeconds << " s\n";
+
+    OptimalSink sink(solver, maxLength, threads);
+    MoveParser parser(sink);
+    if (!parser.ParseStream(std::cin)){
+        std::cerr << "input: " << parser.GetError() << "\n";
+        return 1;
+    }
+    if (sink.solves > 0){
+        std::cerr << "solved: " << sink.solves << ", nodes: " << sink.totalNodes
+                  << ", time: " << sink.totalSeconds << " s"
+                  << ", " << sink.totalNodes/sink.totalSeconds/1e6 << " M nodes/s\n";
+    }
+    return sink.failed > 0 ? 1 : 0;
+}
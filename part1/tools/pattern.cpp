@@ -0,0 +1,107 @@
+// Solves every line of a scramble file to a goal other than the solved cube:
+// a pattern like the checkerboard, or a partial goal like the cross. The goal
+// is one of the names below or a move sequence that makes the target from
+// the solved cube. Solutions are shortest, found by the optimal solver with
+// its pattern databases, which every goal shares.
+// Usage: ./pattern <goal> [max length] [table directory] < scrambles > solutions
+#include "Goal.hpp"
+#include "MoveParser.hpp"
+#include "OptimalSolver.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// scrambles a cube while a line is parsed and solves it to the goal at the end of the line
+class PatternSink : public MoveParser::Sink{
+public:
+    PatternSink(const OptimalSolver& solver, const Goal& goal, int maxLength)
+        :m_solver(solver), m_goal(goal), m_maxLength(maxLength){}
+    void OnMove(Move move) override{
+        m_cube.ApplyMove(move);
+    }
+    void OnSequenceEnd() override{
+        OptimalSolver::Statistics statistics;
+        bool solved = m_solver.Solve(m_cube, m_goal, m_solution, &statistics, m_maxLength);
+        if (!solved){
+            std::cout << "no solution within " << m_maxLength << " moves\n";
+            failed++;
+            m_cube.Reset();
+            return;
+        }
+        // check the goal really is reached, the centers end up home
+        for (Move move : m_solution){
+            m_cube.ApplyMove(move);
+        }
+        if (!m_goal.IsReachedBy(CubieCube::FromState(m_cube))){
+            wrong++;
+        }
+        m_cube.Reset();
+        std::cout << MoveParser::ToString(m_solution) << "\n";
+        std::cerr << "  " << m_solution.size() << " moves, " << statistics.nodes << " nodes in "
+                  << statistics.seconds << " s\n";
+        solves++;
+        totalMoves += m_solution.size();
+        totalSeconds += statistics.seconds;
+    }
+
+    long long solves = 0;
+    long long failed = 0;
+    long long wrong = 0;
+    long long totalMoves = 0;
+    double totalSeconds = 0.0;
+
+private:
+    const OptimalSolver& m_solver;
+    const Goal& m_goal;
+    int m_maxLength;
+    CubeState m_cube;
+    std::vector<Move> m_solution;
+};
+
+int main(int argc, char** argv){
+    std::ios::sync_with_stdio(false);
+    if (argc < 2){
+        std::cout << "Usage: " << argv[0] << " <goal> [max length] [table directory] < scrambles\n";
+        std::cout << "goals:";
+        for (const std::string& name : Goal::Names()){
+            std::cout << " " << name;
+        }
+        std::cout << ", or the moves that make the target\n";
+        return 1;
+    }
+    Goal goal;
+    if (!Goal::FromName(argv[1], goal)){
+        std::vector<Move> moves;
+        std::string error;
+        if (!MoveParser::ParseString(argv[1], moves, &error)){
+            std::cout << "Unknown goal " << argv[1] << ": " << error << "\n";
+            return 1;
+        }
+        goal = Goal::FromMoves(moves);
+    }
+    int maxLength = argc > 2 ? std::atoi(argv[2]) : OptimalSolver::MAX_LENGTH;
+    std::string directory = argc > 3 ? argv[3] : "tables";
+
+    auto start = std::chrono::steady_clock::now();
+    OptimalSolver solver(directory);
+    double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "tables: " << solver.TablesLoaded() << "/" << OptimalSolver::NUM_TABLES << " mapped from "
+              << directory << ", ready in " << tableSeconds << " s\n";
+
+    PatternSink sink(solver, goal, maxLength);
+    MoveParser parser(sink);
+    if (!parser.ParseStream(std::cin)){
+        std::cerr << "input: " << parser.GetError() << "\n";
+        return 1;
+    }
+    if (sink.solves > 0){
+        std::cerr << "solved: " << sink.solves << ", average length: " << double(sink.totalMoves)/sink.solves
+                  << ", time: " << sink.totalSeconds << " s\n";
+    }
+    if (sink.failed > 0 || sink.wrong > 0){
+        std::cerr << "not solved: " << sink.failed << ", goal missed: " << sink.wrong << "\n";
+    }
+    return sink.failed > 0 || sink.wrong > 0 ? 1 : 0;
+}
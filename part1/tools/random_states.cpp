@@ -0,0 +1,88 @@
+// Generates uniformly random cubes for test corpora. Every state a cube can
+// reach is equally likely, unlike random turns. Prints one scramble per
+// line that reaches the state, the inverse of a Thistlethwaite solution, so
+// the output can be fed to ./replay or ./batch_solve. The index-th state of
+// a seed is always the same whatever the thread count. With "none" the
+// states are only generated and counted, to measure the generator alone.
+// Usage: ./random_states [count] [seed] [threads] [scrambles|none] > scrambles
+#include "MoveParser.hpp"
+#include "RandomState.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv){
+    std::ios::sync_with_stdio(false);
+    uint64_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2463534242u;
+    int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+    if (threads <= 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    bool scrambles = argc > 4 ? std::string(argv[4]) != "none" : true;
+
+    ThistlethwaiteSolver solver;
+    auto start = std::chrono::steady_clock::now();
+    // states are made a batch at a time, each thread writes its own slice
+    // of the batch and the slices are printed in order
+    const uint64_t BATCH = 1 << 16;
+    std::vector<std::string> output(threads);
+    std::vector<uint64_t> checksums(threads, 0);
+    uint64_t failed = 0;
+    for (uint64_t first=0; first<count; first+=BATCH){
+        uint64_t size = std::min(BATCH, count - first);
+        std::vector<uint64_t> failures(threads, 0);
+        auto generate = [&](int thread){
+            output[thread].clear();
+            uint64_t end = first + size*(thread+1)/threads;
+            for (uint64_t index = first + size*thread/threads; index<end; index++){
+                CubieCube cube = RandomState::Generate(seed, index);
+                if (!scrambles){
+                    // keeps the state from being optimized away
+                    checksums[thread] += cube.CornerPerm() ^ cube.Twist() ^ cube.Flip() ^ cube.ep[0];
+                    continue;
+                }
+                std::vector<Move> scramble = RandomState::Scramble(cube, solver);
+                if (scramble.empty()){
+                    failures[thread]++;
+                }
+                output[thread] += MoveParser::ToString(scramble);
+                output[thread] += '\n';
+            }
+        };
+        std::vector<std::thread> workers;
+        for (int thread=1; thread<threads; thread++){
+            workers.emplace_back(generate, thread);
+        }
+        generate(0);
+        for (std::thread& worker : workers){
+            worker.join();
+        }
+        for (int thread=0; thread<threads; thread++){
+            std::cout << output[thread];
+            failed += failures[thread];
+        }
+    }
+    std::cout.flush();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t checksum = 0;
+    for (uint64_t value : checksums){
+        checksum += value;
+    }
+    std::cerr << "states: " << count << ", seed: " << seed << ", threads: " << threads
+              << ", time: " << seconds << " s, " << count/seconds/1e6*60 << " M states/minute";
+    if (!scrambles){
+        std::cerr << ", checksum " << checksum;
+    }
+    std::cerr << "\n";
+    if (failed > 0){
+        std::cerr << "not solvable: " << failed << "\n";
+    }
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,82 @@
+// Replays move scripts straight into the cube engine and reports throughput.
+// Every line of the input is one sequence, applied to a cube that starts solved.
+// A sequence counts as solved with the centers spun any way, like the solvers
+// leave them; --strict also wants the centers unspun.
+// Usage: ./replay [--strict] <file|-> [more files]   ("-" reads stdin, MB/s is only shown for files)
+#include "MoveParser.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// applies moves as they are parsed and counts which sequences solve the cube
+class ReplaySink : public MoveParser::Sink{
+public:
+    ReplaySink(bool strict):m_strict(strict){}
+    void OnMove(Move move) override{
+        m_cube.ApplyMove(move);
+        moves++;
+    }
+    void OnSequenceEnd() override{
+        sequences++;
+        if (m_strict ? m_cube.IsSolved() : m_cube.IsSolvedIgnoringCenterSpin()){
+            solvedSequences++;
+        }
+        m_cube.Reset();
+    }
+
+    long long moves = 0;
+    long long sequences = 0;
+    long long solvedSequences = 0;
+
+private:
+    bool m_strict;
+    CubeState m_cube;
+};
+
+int main(int argc, char** argv){
+    bool strict = argc > 1 && std::string(argv[1]) == "--strict";
+    int firstPath = strict ? 2 : 1;
+    if (argc <= firstPath){
+        std::cout << "Usage: " << argv[0] << " [--strict] <file|-> [more files]\n";
+        return 1;
+    }
+
+    ReplaySink sink(strict);
+    long long bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i=firstPath; i<argc; i++){
+        std::string path = argv[i];
+        MoveParser parser(sink);
+        bool ok;
+        if (path == "-"){
+            ok = parser.ParseStream(std::cin);
+        } else {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file){
+                std::cout << "Could not open " << path << "\n";
+                return 1;
+            }
+            bytes += file.tellg();
+            file.seekg(0);
+            ok = parser.ParseStream(file);
+        }
+        if (!ok){
+            std::cout << path << ": " << parser.GetError() << "\n";
+            return 1;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "moves: " << sink.moves
+              << ", sequences: " << sink.sequences
+              << ", solved: " << sink.solvedSequences << "\n";
+    std::cout << "time: " << seconds << " s"
+              << ", moves/s: " << sink.moves/seconds;
+    if (bytes > 0){
+        std::cout << ", MB/s: " << bytes/seconds/1e6;
+    }
+    std::cout << "\n";
+    return 0;
+}
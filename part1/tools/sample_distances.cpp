@@ -0,0 +1,286 @@
+// Estimates how far random cubes are from solved: solves uniformly random
+// states (see ./random_states) on every core and prints a histogram of the
+// solution lengths, percentiles of the time per solve and nodes per second.
+// Optimal solutions give the real distances, two-phase ones upper bounds
+// in a fraction of the time.
+// Every result is printed as soon as it is found, as
+//   <state index> <length> <milliseconds> <nodes> <solution>
+// and appended to the checkpoint file. Running again with the same file
+// skips the states it already has, so a long run can be stopped at any time
+// and resumed, or extended to a larger count. The seed and solver have to
+// match the ones the file was started with.
+// Usage: ./sample_distances <count> [twophase|optimal] [threads] [seed] [checkpoint file] [table directory] > results
+#include "MoveParser.hpp"
+#include "OptimalSolver.hpp"
+#include "RandomState.hpp"
+#include "TwoPhaseSolver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// one solved state
+struct Sample{
+    uint64_t index;
+    int length;
+    double milliseconds;
+    long long nodes;
+};
+
+// Reads the samples a checkpoint file holds, false if it was started with
+// another seed or solver. A line cut short by an interrupted run is
+// dropped from the file so new results start on a line of their own.
+bool ReadCheckpoint(const std::string& path, const std::string& header, std::vector<Sample>& samples){
+    std::ifstream file(path, std::ios::binary);
+    if (!file){
+        return true;
+    }
+    std::string line;
+    std::streamoff complete = 0;
+    bool first = true;
+    while (std::getline(file, line)){
+        if (file.eof()){
+            // no newline at the end, the run stopped while writing it
+            break;
+        }
+        complete = file.tellg();
+        if (first){
+            first = false;
+            if (line != header){
+                std::cout << path << " was started as \"" << line << "\", not \"" << header
+                          << "\", use another checkpoint file\n";
+                return false;
+            }
+            continue;
+        }
+        std::istringstream fields(line);
+        Sample sample;
+        if (fields >> sample.index >> sample.length >> sample.milliseconds >> sample.nodes){
+            samples.push_back(sample);
+        }
+    }
+    file.close();
+    std::error_code error;
+    if (std::filesystem::file_size(path, error) != uint64_t(complete)){
+        std::filesystem::resize_file(path, complete, error);
+        if (error){
+            std::cout << "Could not truncate " << path << ", " << error.message() << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Value below which a fraction of the sorted values are
+double Percentile(const std::vector<double>& sorted, double fraction){
+    size_t rank = std::min(sorted.size() - 1, size_t(fraction*sorted.size()));
+    return sorted[rank];
+}
+
+int main(int argc, char** argv){
+    std::ios::sync_with_stdio(false);
+    if (argc < 2){
+        std::cout << "Usage: " << argv[0] << " <count> [twophase|optimal] [threads] [seed] [checkpoint file] [table directory]\n";
+        return 1;
+    }
+    uint64_t count = std::strtoull(argv[1], nullptr, 10);
+    std::string solverName = argc > 2 ? argv[2] : "twophase";
+    int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+    if (threads <= 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    uint64_t seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 2463534242u;
+    std::string checkpointPath = argc > 5 ? argv[5] : "sample.checkpoint";
+    std::string directory = argc > 6 ? argv[6] : "tables";
+    if (solverName != "twophase" && solverName != "optimal"){
+        std::cout << "Unknown solver " << solverName << ", use twophase or optimal\n";
+        return 1;
+    }
+
+    // states already solved by an earlier run
+    std::string header = "// sample_distances seed " + std::to_string(seed) + " solver " + solverName;
+    std::vector<Sample> samples;
+    if (!ReadCheckpoint(checkpointPath, header, samples)){
+        return 1;
+    }
+    std::vector<bool> done(count, false);
+    for (const Sample& sample : samples){
+        if (sample.index < count){
+            done[sample.index] = true;
+        }
+    }
+    std::vector<uint64_t> remaining;
+    for (uint64_t index=0; index<count; index++){
+        if (!done[index]){
+            remaining.push_back(index);
+        }
+    }
+    std::error_code error;
+    bool fresh = !std::filesystem::exists(checkpointPath) || std::filesystem::file_size(checkpointPath, error) == 0;
+    std::ofstream checkpoint(checkpointPath, std::ios::binary | std::ios::app);
+    if (!checkpoint){
+        std::cout << "Could not open " << checkpointPath << "\n";
+        return 1;
+    }
+    if (fresh){
+        checkpoint << header << "\n";
+        checkpoint.flush();
+    }
+
+    // one solver shared by every worker, both are safe to share
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<TwoPhaseSolver> twoPhase;
+    std::unique_ptr<OptimalSolver> optimal;
+    if (solverName == "optimal"){
+        optimal.reset(new OptimalSolver(directory, threads));
+        std::cerr << "tables: " << optimal->TablesLoaded() << "/" << OptimalSolver::NUM_TABLES
+                  << " mapped from " << directory;
+    } else {
+        twoPhase.reset(new TwoPhaseSolver());
+        std::cerr << "tables built";
+    }
+    double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << " in " << tableSeconds << " s, " << samples.size() << " states from " << checkpointPath
+              << ", solving " << remaining.size() << " with " << threads << " threads\n";
+
+    // workers take the next remaining state, results are written in the
+    // order they finish
+    std::atomic<size_t> next(0);
+    std::mutex mutex;
+    std::condition_variable finished;
+    int running = threads;
+    long long failed = 0;
+    long long wrong = 0;
+    long long sessionNodes = 0;
+    size_t sessionSolves = 0;
+    auto work = [&](){
+        std::vector<Move> solution;
+        for (size_t position = next++; position < remaining.size(); position = next++){
+            uint64_t index = remaining[position];
+            CubeState cube = RandomState::Generate(seed, index).ToState();
+            auto solveStart = std::chrono::steady_clock::now();
+            long long nodes = 0;
+            bool solved;
+            if (optimal){
+                OptimalSolver::Statistics statistics;
+                solved = optimal->Solve(cube, solution, &statistics);
+                nodes = statistics.nodes;
+            } else {
+                solved = twoPhase->Solve(cube, solution, 20, 0.1, &nodes);
+            }
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - solveStart).count();
+
+            bool correct = solved;
+            if (solved){
+                CubeState check = cube;
+                for (Move move : solution){
+                    check.ApplyMove(move);
+                }
+                correct = check.IsSolvedIgnoringCenterSpin();
+            }
+            std::ostringstream line;
+            line << index << " " << solution.size() << " " << milliseconds << " " << nodes << " "
+                 << MoveParser::ToString(solution) << "\n";
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!correct){
+                // left out of the checkpoint, so a resumed run tries again
+                if (solved){
+                    wrong++;
+                } else {
+                    failed++;
+                }
+                continue;
+            }
+            checkpoint << line.str();
+            checkpoint.flush();
+            std::cout << line.str();
+            std::cout.flush();
+            samples.push_back(Sample{index, int(solution.size()), milliseconds, nodes});
+            sessionNodes += nodes;
+            sessionSolves++;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        running--;
+        finished.notify_all();
+    };
+
+    start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int worker=0; worker<threads; worker++){
+        workers.emplace_back(work);
+    }
+    // progress every few seconds while the workers run
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!finished.wait_for(lock, std::chrono::seconds(10), [&]{ return running == 0; })){
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            double rate = sessionSolves/seconds;
+            std::cerr << "progress: " << samples.size() << "/" << count << ", " << rate << " solves/s";
+            if (rate > 0.0){
+                std::cerr << ", about " << (remaining.size() - sessionSolves)/rate << " s left";
+            }
+            std::cerr << "\n";
+        }
+    }
+    for (std::thread& worker : workers){
+        worker.join();
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // statistics over every state of the sample, this run's and earlier ones
+    std::vector<long long> histogram;
+    std::vector<double> times;
+    long long totalNodes = 0;
+    double totalMilliseconds = 0.0;
+    long long totalMoves = 0;
+    size_t counted = 0;
+    for (const Sample& sample : samples){
+        if (sample.index >= count){
+            continue;
+        }
+        if (int(histogram.size()) <= sample.length){
+            histogram.resize(sample.length + 1, 0);
+        }
+        histogram[sample.length]++;
+        times.push_back(sample.milliseconds);
+        totalNodes += sample.nodes;
+        totalMilliseconds += sample.milliseconds;
+        totalMoves += sample.length;
+        counted++;
+    }
+    if (counted > 0){
+        std::cerr << "length  states  fraction\n";
+        for (size_t length=0; length<histogram.size(); length++){
+            if (histogram[length] > 0){
+                std::cerr << length << "  " << histogram[length] << "  " << double(histogram[length])/counted << "\n";
+            }
+        }
+        std::sort(times.begin(), times.end());
+        std::cerr << "states: " << counted << ", average length: " << double(totalMoves)/counted << "\n"
+                  << "time per solve: p50 " << Percentile(times, 0.5) << " ms, p90 " << Percentile(times, 0.9)
+                  << " ms, p99 " << Percentile(times, 0.99) << " ms, max " << times.back() << " ms\n";
+        if (totalMilliseconds > 0.0){
+            std::cerr << "nodes: " << totalNodes << ", " << totalNodes/totalMilliseconds*1e3 << " per second per thread";
+            if (sessionSolves > 0){
+                std::cerr << ", " << sessionNodes/wallSeconds << " per second on " << threads << " threads this run";
+            }
+            std::cerr << "\n";
+        }
+    }
+    if (failed > 0 || wrong > 0){
+        std::cerr << "not solved: " << failed << ", wrong solutions: " << wrong << "\n";
+    }
+    return failed > 0 || wrong > 0 ? 1 : 0;
+}
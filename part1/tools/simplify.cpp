@@ -0,0 +1,65 @@
+// Rewrites move scripts as canonical, simplified sequences, one per line.
+// Usage: ./simplify [htm|qtm|stm] < input > output
+#include "MoveParser.hpp"
+#include "MoveSimplifier.hpp"
+
+#include <iostream>
+
+// simplifies each line as it is parsed and writes it out
+class SimplifySink : public MoveParser::Sink{
+public:
+    SimplifySink(MoveSimplifier::Metric metric):m_metric(metric), m_simplifier(metric){}
+    void OnMove(Move move) override{
+        m_simplifier.Push(move);
+        movesIn++;
+        costIn += MoveSimplifier::Cost(&move, 1, m_metric);
+    }
+    void OnSequenceEnd() override{
+        m_moves.clear();
+        m_simplifier.Write(m_moves);
+        m_simplifier.Clear();
+        movesOut += m_moves.size();
+        costOut += MoveSimplifier::Cost(m_moves, m_metric);
+        // the output buffer is reused, one line never allocates once it is big enough
+        m_line.clear();
+        for (size_t i=0; i<m_moves.size(); i++){
+            if (i > 0){
+                m_line += ' ';
+            }
+            m_line += MoveParser::Name(m_moves[i]);
+        }
+        m_line += '\n';
+        std::cout.write(m_line.data(), m_line.size());
+    }
+
+    long long movesIn = 0;
+    long long movesOut = 0;
+    long long costIn = 0;
+    long long costOut = 0;
+
+private:
+    MoveSimplifier::Metric m_metric;
+    MoveSimplifier m_simplifier;
+    std::vector<Move> m_moves;
+    std::string m_line;
+};
+
+int main(int argc, char** argv){
+    std::ios::sync_with_stdio(false);
+    MoveSimplifier::Metric metric = MoveSimplifier::Metric::STM;
+    if (argc > 1 && !MoveSimplifier::ParseMetric(argv[1], metric)){
+        std::cerr << "Usage: " << argv[0] << " [htm|qtm|stm] < input > output\n";
+        return 1;
+    }
+
+    SimplifySink sink(metric);
+    MoveParser parser(sink);
+    if (!parser.ParseStream(std::cin)){
+        std::cerr << "input: " << parser.GetError() << "\n";
+        return 1;
+    }
+    std::cout.flush();
+    std::cerr << "moves: " << sink.movesIn << " -> " << sink.movesOut
+              << ", " << MoveSimplifier::Name(metric) << ": " << sink.costIn << " -> " << sink.costOut << "\n";
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Solves every line of a scramble file with the two-phase solver.
+// Prints one solution per line, and a summary of lengths and times at the end.
+// Usage: ./solve [target length] [max seconds per cube] < scrambles > solutions
+#include "MoveParser.hpp"
+#include "TwoPhaseSolver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// scrambles a cube while a line is parsed and solves it at the end of the line
+class SolveSink : public MoveParser::Sink{
+public:
+    SolveSink(const TwoPhaseSolver& solver, int targetLength, double maxSeconds)
+        :m_solver(solver), m_targetLength(targetLength), m_maxSeconds(maxSeconds){}
+    void OnMove(Move move) override{
+        m_cube.ApplyMove(move);
+    }
+    void OnSequenceEnd() override{
+        CubeState scrambled = m_cube;
+        auto start = std::chrono::steady_clock::now();
+        bool solved = m_solver.Solve(m_cube, m_solution, m_targetLength, m_maxSeconds);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        m_cube.Reset();
+
+        if (!solved){
+            std::cout << "unsolvable\n";
+            failed++;
+            return;
+        }
+        std::cout << MoveParser::ToString(m_solution) << "\n";
+        for (Move move : m_solution){
+            scrambled.ApplyMove(move);
+        }
+        if (!scrambled.IsSolvedIgnoringCenterSpin()){
+            wrong++;
+        }
+        solves++;
+        totalMoves += m_solution.size();
+        totalSeconds += seconds;
+        maxSeconds = std::max(maxSeconds, seconds);
+    }
+
+    long long solves = 0;
+    long long failed = 0;
+    // solutions that do not solve their scramble
+    long long wrong = 0;
+    long long totalMoves = 0;
+    double totalSeconds = 0.0;
+    double maxSeconds = 0.0;
+
+private:
+    const TwoPhaseSolver& m_solver;
+    int m_targetLength;
+    double m_maxSeconds;
+    CubeState m_cube;
+    std::vector<Move> m_solution;
+};
+
+int main(int argc, char** argv){
+    std::ios::sync_with_stdio(false);
+    int targetLength = argc > 1 ? std::atoi(argv[1]) : 20;
+    double maxSeconds = argc > 2 ? std::atof(argv[2]) : 0.1;
+
+    auto start = std::chrono::steady_clock::now();
+    TwoPhaseSolver solver;
+    double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "tables built in " << tableSeconds << " s\n";
+
+    SolveSink sink(solver, targetLength, maxSeconds);
+    MoveParser parser(sink);
+    if (!parser.ParseStream(std::cin)){
+        std::cerr << "input: " << parser.GetError() << "\n";
+        return 1;
+    }
+    if (sink.solves > 0){
+        std::cerr << "solved: " << sink.solves
+                  << ", average length: " << double(sink.totalMoves)/sink.solves
+                  << ", average time: " << sink.totalSeconds/sink.solves*1e3 << " ms"
+                  << ", max time: " << sink.maxSeconds*1e3 << " ms\n";
+    }
+    if (sink.failed > 0 || sink.wrong > 0){
+        std::cerr << "unsolvable: " << sink.failed << ", wrong solutions: " << sink.wrong << "\n";
+    }
+    return sink.failed > 0 || sink.wrong > 0 ? 1 : 0;
+}